@@ -0,0 +1,136 @@
+#ifndef ADC_SENSOR_HPP
+#define ADC_SENSOR_HPP
+
+#include "BinaryLog.hpp"
+#include "Board.hpp"
+
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "esp_adc/adc_oneshot.h"
+#include "esp_log.h"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace autflr {
+    constexpr adc_atten_t ADC_ATTENUATION = ADC_ATTEN_DB_12;
+    constexpr adc_bitwidth_t ADC_WIDTH = ADC_BITWIDTH_10;
+
+    /**
+     * One-shot ADC unit, created on the first read of a sensor on it and kept until reset.
+     */
+    template<adc_unit_t Unit>
+    class AdcUnit {
+    public:
+        AdcUnit() = delete;
+
+        static adc_oneshot_unit_handle_t getHandle() {
+            static const adc_oneshot_unit_handle_t handle = [] {
+                const adc_oneshot_unit_init_cfg_t config{
+                    .unit_id = Unit,
+                    .clk_src = ADC_RTC_CLK_SRC_DEFAULT,
+                    .ulp_mode = ADC_ULP_MODE_DISABLE,
+                };
+                adc_oneshot_unit_handle_t created = nullptr;
+
+                ESP_ERROR_CHECK(adc_oneshot_new_unit(&config, &created));
+                return created;
+            }();
+
+            return handle;
+        }
+
+        /**
+         * @return nullptr if the chip has no line fitting calibration.
+         */
+        static adc_cali_handle_t getCalibration() {
+            static const adc_cali_handle_t handle = [] {
+                adc_cali_scheme_ver_t schemeMask{};
+                adc_cali_handle_t created = nullptr;
+
+                adc_cali_check_scheme(&schemeMask);
+                if (schemeMask & ADC_CALI_SCHEME_VER_LINE_FITTING) {
+                    const adc_cali_line_fitting_config_t config = {
+                        .unit_id = Unit,
+                        .atten = ADC_ATTENUATION,
+                        .bitwidth = ADC_WIDTH,
+                    };
+
+                    ESP_ERROR_CHECK(adc_cali_create_scheme_line_fitting(&config, &created));
+                }
+
+                return created;
+            }();
+
+            return handle;
+        }
+    };
+
+    /**
+     * Driver of one analog input of the board description. Dispatch is static and only the inputs
+     * the firmware reads get instantiated, so a device that is not fitted costs no code.
+     */
+    template<AdcInput Input>
+    class AdcSensor {
+        static_assert(Input.isFitted, "The input is not fitted on this board");
+
+    public:
+        AdcSensor() = delete;
+
+        /**
+         * @return Raw reading, std::nullopt if the read failed. 0 is a valid reading.
+         */
+        static std::optional<uint16_t> getValueRaw() {
+            int value = 0;
+
+            if (adc_oneshot_read(getHandle(), Input.channel, &value) != ESP_OK) {
+                AFLR_LOGE(TAG.data(), "Failed to read from ADC");
+                return std::nullopt;
+            }
+
+            return static_cast<uint16_t>(value);
+        }
+
+        /**
+         * @return Voltage in mV, 0 if the read failed or the chip has no calibration.
+         */
+        static uint16_t getValueCalibrated() {
+            const auto calibration = AdcUnit<Input.unit>::getCalibration();
+            int value = 0;
+
+            if (calibration == nullptr
+                || adc_oneshot_get_calibrated_result(getHandle(), calibration, Input.channel, &value) != ESP_OK
+            ) {
+                AFLR_LOGE(TAG.data(), "Failed to read calibrated value from ADC");
+                return 0;
+            }
+
+            return static_cast<uint16_t>(value);
+        }
+
+    private:
+        static adc_oneshot_unit_handle_t getHandle() {
+            static const adc_oneshot_unit_handle_t handle = [] {
+                const adc_oneshot_chan_cfg_t config{.atten = ADC_ATTENUATION, .bitwidth = ADC_WIDTH};
+                const auto unit = AdcUnit<Input.unit>::getHandle();
+
+                ESP_ERROR_CHECK(adc_oneshot_config_channel(unit, Input.channel, &config));
+                return unit;
+            }();
+
+            return handle;
+        }
+
+        static constexpr std::string_view TAG =
+            Input.kind == SensorKind::MOISTURE ? "[MOISTURE SENSOR]"
+            : Input.kind == SensorKind::WATER_LEVEL ? "[WATER SENSOR]"
+            : "[SUPPLY SENSOR]";
+    };
+
+    using MoistureSensor = AdcSensor<BOARD.moisture>;
+    using WaterSensor = AdcSensor<BOARD.waterLevel>;
+    using SupplySensor = AdcSensor<BOARD.supplyVoltage>;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifndef BINARY_LOG_HPP
+#define BINARY_LOG_HPP
+
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if CONFIG_ENABLE_BINARY_LOG
+    // The tag and the formatting are dropped, only the format string address and raw arguments are stored.
+    #define AFLR_LOGE(tag, format, ...) ::autflr::BinaryLog::record(ESP_LOG_ERROR, format, ##__VA_ARGS__)
+    #define AFLR_LOGW(tag, format, ...) ::autflr::BinaryLog::record(ESP_LOG_WARN, format, ##__VA_ARGS__)
+    #define AFLR_LOGI(tag, format, ...) ::autflr::BinaryLog::record(ESP_LOG_INFO, format, ##__VA_ARGS__)
+#else
+    #define AFLR_LOGE(tag, format, ...) ESP_LOGE(tag, format, ##__VA_ARGS__)
+    #define AFLR_LOGW(tag, format, ...) ESP_LOGW(tag, format, ##__VA_ARGS__)
+    #define AFLR_LOGI(tag, format, ...) ESP_LOGI(tag, format, ##__VA_ARGS__)
+#endif
+
+namespace autflr {
+    /**
+     * Deferred binary log in an RTC memory ring buffer. A record is the format string's flash address,
+     * the level, the argument count, the RTC time and the raw arguments. tools/binlog_decode.py turns
+     * the flushed records back into text using the ELF.
+     */
+    class BinaryLog {
+    public:
+        BinaryLog() = delete;
+
+        template<typename... Args>
+        static void record(esp_log_level_t level, const char* format, Args... args) {
+            if (level > LOG_LOCAL_LEVEL) {
+                return;
+            }
+
+            std::array<uint32_t, countWords<Args...>()> words{};
+            [[maybe_unused]] size_t index = 0;
+
+            (pack(words, index, args), ...);
+            append(level, format, words.data(), words.size());
+        }
+
+        /**
+         * @brief Prints every record as one "#BL" line of hex words and empties the buffer. Safe against
+         * concurrent writers, records added while printing wait for the next flush.
+         * Like getUsedPercent(), only built with CONFIG_ENABLE_BINARY_LOG.
+         */
+        static void flush();
+
+        static uint8_t getUsedPercent();
+
+    private:
+        template<typename... Args>
+        static constexpr size_t countWords() {
+            return (0 + ... + (sizeof(Args) > sizeof(uint32_t) ? 2 : 1));
+        }
+
+        template<size_t N, typename T>
+        static void pack(std::array<uint32_t, N>& words, size_t& index, T value) {
+            if constexpr (std::is_floating_point_v<T>) {
+                const float narrowed = static_cast<float>(value); // Decoded as float32 by the host tool.
+                std::memcpy(&words[index++], &narrowed, sizeof(narrowed));
+            } else if constexpr (std::is_pointer_v<T>) {
+                words[index++] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value));
+            } else if constexpr (sizeof(T) > sizeof(uint32_t)) {
+                const auto wide = static_cast<uint64_t>(value);
+                words[index++] = static_cast<uint32_t>(wide);
+                words[index++] = static_cast<uint32_t>(wide >> 32);
+            } else {
+                words[index++] = static_cast<uint32_t>(value);
+            }
+        }
+
+        static void append(esp_log_level_t level, const char* format, const uint32_t* args, size_t argWords);
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,177 @@
+#ifndef BOARD_HPP
+#define BOARD_HPP
+
+#include "hal/adc_types.h"
+#include "hal/gpio_types.h"
+#include "sdkconfig.h"
+#include "soc/soc_caps.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace autflr {
+    #if CONFIG_ENABLE_WATER_SENSOR
+        constexpr bool HAS_WATER_SENSOR = true;
+    #else
+        constexpr bool HAS_WATER_SENSOR = false;
+    #endif
+    #if CONFIG_ENABLE_FLOW_METER
+        constexpr bool HAS_FLOW_METER = true;
+    #else
+        constexpr bool HAS_FLOW_METER = false;
+    #endif
+    #if CONFIG_ENABLE_LCD
+        constexpr bool HAS_LCD = true;
+    #else
+        constexpr bool HAS_LCD = false;
+    #endif
+    #if CONFIG_ENABLE_SUPPLY_MONITOR
+        constexpr bool HAS_SUPPLY_MONITOR = true;
+    #else
+        constexpr bool HAS_SUPPLY_MONITOR = false;
+    #endif
+
+    enum class SensorKind : uint8_t {
+        MOISTURE,
+        WATER_LEVEL,
+        SUPPLY_VOLTAGE,
+    };
+
+    struct AdcInput {
+        SensorKind kind;
+        adc_unit_t unit;
+        adc_channel_t channel;
+        bool isFitted;
+    };
+
+    struct I2cBusPins {
+        gpio_num_t sda;
+        gpio_num_t scl;
+        uint32_t frequencyHz;
+    };
+
+    struct BoardDescription {
+        AdcInput moisture;
+        AdcInput waterLevel;
+        AdcInput supplyVoltage;
+        uint8_t supplyDivider; // Supply voltage over the voltage at the ADC pin.
+        gpio_num_t sensorRail; // Powers the probes only while measuring.
+        gpio_num_t pumpRail; // Driven by LEDC for the soft start.
+        gpio_num_t warningLed;
+        gpio_num_t settingsButton; // ext0 wake on LOW, keep it pulled HIGH. Must be an RTC GPIO.
+        gpio_num_t flowMeter; // GPIO_NUM_NC if not fitted.
+        uint8_t lcdAddress;
+    };
+
+    /**
+     * The board revision. Every pin, ADC channel and power rail the firmware touches is here, the
+     * Kconfig "Available Devices" menu only decides which devices are fitted.
+     */
+    inline constexpr BoardDescription BOARD = {
+        .moisture = {SensorKind::MOISTURE, ADC_UNIT_1, ADC_CHANNEL_6, true},
+        .waterLevel = {SensorKind::WATER_LEVEL, ADC_UNIT_1, ADC_CHANNEL_7, HAS_WATER_SENSOR},
+        .supplyVoltage = {SensorKind::SUPPLY_VOLTAGE, ADC_UNIT_1, ADC_CHANNEL_3, HAS_SUPPLY_MONITOR},
+        .supplyDivider = 2, // Two equal resistors keep a full Li-ion cell within the 12 dB range.
+        .sensorRail = GPIO_NUM_32,
+        .pumpRail = GPIO_NUM_33,
+        .warningLed = GPIO_NUM_25,
+        .settingsButton = GPIO_NUM_26,
+        .flowMeter = HAS_FLOW_METER ? GPIO_NUM_27 : GPIO_NUM_NC,
+        .lcdAddress = 0x27,
+    };
+
+    /**
+     * One entry per I2C controller, bus 0 holds the LCD. Add e.g. {GPIO_NUM_18, GPIO_NUM_19, 100000}
+     * to keep sensors off the display's bus.
+     */
+    inline constexpr std::array I2C_BUSES = {
+        I2cBusPins{GPIO_NUM_21, GPIO_NUM_22, 400000},
+    };
+
+    constexpr gpio_num_t adcPin(const AdcInput& input) {
+        #if CONFIG_IDF_TARGET_ESP32
+            constexpr std::array<gpio_num_t, 8> ADC1_PINS = {
+                GPIO_NUM_36, GPIO_NUM_37, GPIO_NUM_38, GPIO_NUM_39, GPIO_NUM_32, GPIO_NUM_33, GPIO_NUM_34, GPIO_NUM_35
+            };
+            constexpr std::array<gpio_num_t, 10> ADC2_PINS = {
+                GPIO_NUM_4, GPIO_NUM_0, GPIO_NUM_2, GPIO_NUM_15, GPIO_NUM_13,
+                GPIO_NUM_12, GPIO_NUM_14, GPIO_NUM_27, GPIO_NUM_25, GPIO_NUM_26
+            };
+
+            return input.unit == ADC_UNIT_1 ? ADC1_PINS[input.channel] : ADC2_PINS[input.channel];
+        #else
+            return GPIO_NUM_NC; // Pin checks of analog inputs are ESP32-only.
+        #endif
+    }
+
+    constexpr bool isOutputCapable(gpio_num_t pin) {
+        #if CONFIG_IDF_TARGET_ESP32
+            return pin < GPIO_NUM_34; // GPIO34-39 are input-only.
+        #else
+            return pin != GPIO_NUM_NC;
+        #endif
+    }
+
+    /**
+     * Every pin in use, GPIO_NUM_NC for devices that are not fitted.
+     */
+    inline constexpr auto BOARD_PINS = [] {
+        constexpr size_t FIXED_PINS = 8;
+        std::array<gpio_num_t, FIXED_PINS + 2 * I2C_BUSES.size()> pins{
+            BOARD.moisture.isFitted ? adcPin(BOARD.moisture) : GPIO_NUM_NC,
+            BOARD.waterLevel.isFitted ? adcPin(BOARD.waterLevel) : GPIO_NUM_NC,
+            BOARD.supplyVoltage.isFitted ? adcPin(BOARD.supplyVoltage) : GPIO_NUM_NC,
+            BOARD.sensorRail,
+            BOARD.pumpRail,
+            BOARD.warningLed,
+            BOARD.settingsButton,
+            BOARD.flowMeter,
+        };
+        size_t index = FIXED_PINS;
+
+        for (const auto& bus : I2C_BUSES) {
+            pins[index++] = bus.sda;
+            pins[index++] = bus.scl;
+        }
+
+        return pins;
+    }();
+
+    template<size_t N>
+    constexpr bool hasDuplicatePins(const std::array<gpio_num_t, N>& pins) {
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = i + 1; j < N; ++j) {
+                if (pins[i] != GPIO_NUM_NC && pins[i] == pins[j]) {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    constexpr bool usesAdc2(const AdcInput& input) {
+        return input.isFitted && input.unit == ADC_UNIT_2;
+    }
+
+    static_assert(!hasDuplicatePins(BOARD_PINS), "A pin is assigned twice in the board description");
+    static_assert(
+        !usesAdc2(BOARD.moisture) && !usesAdc2(BOARD.waterLevel) && !usesAdc2(BOARD.supplyVoltage),
+        "ADC2 is unavailable while Wi-Fi is on, analog inputs must be on ADC1"
+    );
+    static_assert(
+        isOutputCapable(BOARD.sensorRail) && isOutputCapable(BOARD.pumpRail) && isOutputCapable(BOARD.warningLed),
+        "Rails and the warning LED need output-capable pins"
+    );
+    static_assert(
+        BOARD.moisture.kind == SensorKind::MOISTURE
+            && BOARD.waterLevel.kind == SensorKind::WATER_LEVEL
+            && BOARD.supplyVoltage.kind == SensorKind::SUPPLY_VOLTAGE,
+        "Sensor kinds do not match their slots"
+    );
+    static_assert(BOARD.supplyDivider > 0, "The supply divider ratio cannot be 0");
+    static_assert(!I2C_BUSES.empty() && I2C_BUSES.size() <= SOC_I2C_NUM, "One to SOC_I2C_NUM I2C buses are supported");
+}
+
+#endif
\ No newline at end of file
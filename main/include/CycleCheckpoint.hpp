@@ -0,0 +1,61 @@
+#ifndef CYCLE_CHECKPOINT_HPP
+#define CYCLE_CHECKPOINT_HPP
+
+#include "esp_system.h"
+
+#include <cstdint>
+
+namespace autflr {
+    enum class CyclePhase : uint8_t {
+        IDLE, // Sleeping between cycles.
+        MEASURING,
+        PUMPING,
+        VERIFYING, // Watering is done, the readings after it are only shown.
+        SCHEDULING,
+    };
+
+    /**
+     * Progress of the irrigation cycle in RTC memory that survives resets other than power-on. After a
+     * brownout or watchdog reset the cycle resumes at the phase it was in and never pumps twice.
+     */
+    class CycleCheckpoint {
+    public:
+        CycleCheckpoint() = delete;
+
+        /**
+         * @brief Loads the checkpoint of the previous boot and records the reset reason. Must be called once,
+         * before any other method. A checkpoint failing its CRC, or left by a normal boot, starts a new cycle.
+         */
+        static void restore();
+
+        /**
+         * @brief True if the previous boot was reset in the middle of a cycle and its phase is to be resumed.
+         */
+        static bool isResuming();
+
+        static CyclePhase getPhase();
+        /**
+         * @brief Saves the phase. Entering MEASURING clears the pump progress of an earlier measurement.
+         */
+        static void enter(CyclePhase phase);
+
+        /**
+         * @brief Saves the pump progress. Called on every poll, so a reset loses at most one poll interval.
+         */
+        static void recordPump(uint32_t elapsedMs, uint32_t deliveredMl);
+        static uint32_t getPumpElapsedMs();
+        static uint32_t getDeliveredMl();
+
+        /**
+         * @brief Brownouts while pumping. Goes up on each one and down by one after every cycle without reset.
+         */
+        static uint8_t getBrownouts();
+
+        /**
+         * @brief Marks the cycle as finished, to be called right before deep sleep.
+         */
+        static void complete();
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef ENERGY_MANAGER_HPP
+#define ENERGY_MANAGER_HPP
+
+#include <cstdint>
+#include <string_view>
+
+namespace autflr {
+    enum class EnergyLevel : uint8_t {
+        NORMAL,
+        SAVING, // LCD off, network on every CONFIG_ENERGY_SAVING_NETWORK_EVERY wakes.
+        LOW, // No network, capped pump time, stretched sleep.
+        CUTOFF, // No cycle at all, only protective sleep.
+    };
+
+    /**
+     * Energy policy driven by the supply voltage. The charge estimate and the level are kept in RTC
+     * memory, so a single noisy reading or a passing cloud does not switch the policy.
+     * Without CONFIG_ENABLE_SUPPLY_MONITOR the level is always NORMAL.
+     */
+    class EnergyManager {
+    public:
+        EnergyManager(const EnergyManager&) = delete;
+        EnergyManager& operator=(const EnergyManager&) = delete;
+
+        static EnergyManager& getInstance() {
+            static EnergyManager instance;
+            return instance;
+        }
+
+        /**
+         * @brief Samples the supply, updates the charge estimate and decides the policy for this wake.
+         * Must be called once per wake, before any other method.
+         */
+        void update();
+
+        EnergyLevel getLevel() const;
+        bool isLcdAllowed() const;
+        bool isNetworkAllowed() const;
+
+        /**
+         * @brief Caps a pump run time to the current level.
+         */
+        uint16_t limitPumpTime(uint16_t seconds) const;
+
+        /**
+         * @return Shortest sleep allowed at the current level in microseconds, 0 if there is no limit.
+         */
+        uint64_t getMinSleepUs() const;
+
+    private:
+        EnergyManager() = default;
+
+        static EnergyLevel levelFor(uint8_t chargePercent);
+        static std::string_view toString(EnergyLevel level);
+
+    private:
+        bool mIsNetworkAllowed{true};
+        static constexpr std::string_view TAG = "[ENERGY]";
+    };
+}
+
+#endif
\ No newline at end of file
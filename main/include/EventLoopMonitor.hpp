@@ -0,0 +1,68 @@
+#ifndef EVENT_LOOP_MONITOR_HPP
+#define EVENT_LOOP_MONITOR_HPP
+
+#include "IrrigationEvent.hpp"
+#include "Statistics.hpp"
+
+#include "esp_event.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+#include <cstdint>
+#include <string_view>
+
+namespace autflr {
+    /**
+     * Measures the default event loop: post-to-dispatch latency, handler run time and the number of
+     * posted but not yet dispatched events. Results are accumulated in the persisted statistics.
+     * Latency is known only for events posted through post(); the payload of WIFI_EVENT and IP_EVENT
+     * carries no timestamp, so only their handler run time is recorded.
+     */
+    class EventLoopMonitor {
+    public:
+        EventLoopMonitor() = delete;
+
+        /**
+         * @brief Posts an event without payload to the default loop, stamped with the post time.
+         */
+        static esp_err_t post(const idf::event::ESPEvent& event);
+
+        /**
+         * @brief Handler trampoline that times Handler. Register it instead of the raw handler.
+         * Irrigation events carry their post stamp as payload, one handler per event id is expected.
+         */
+        template<esp_event_handler_t Handler>
+        static void dispatch(void* arg, esp_event_base_t base, int32_t id, void* data) {
+            #if CONFIG_ENABLE_EVENT_MONITOR
+                const int64_t startUs = esp_timer_get_time();
+
+                if (base == IRRIGATION_EVENT_BASE && data != nullptr) {
+                    recordLatency(static_cast<const PostStamp*>(data)->postedAtUs, startUs);
+                }
+                Handler(arg, base, id, data);
+                recordDuration(base, id, esp_timer_get_time() - startUs);
+            #else
+                Handler(arg, base, id, data);
+            #endif
+        }
+
+        /**
+         * @brief Logs the histograms, the queue high-water mark and the over-budget counters.
+         */
+        static void dump();
+
+    private:
+        struct PostStamp {
+            int64_t postedAtUs;
+        };
+
+        static void recordLatency(int64_t postedAtUs, int64_t dispatchedAtUs);
+        static void recordDuration(esp_event_base_t base, int32_t id, int64_t durationUs);
+        static EventSource sourceOf(esp_event_base_t base);
+
+    private:
+        static constexpr std::string_view TAG = "[EVENT LOOP]";
+    };
+}
+
+#endif
\ No newline at end of file
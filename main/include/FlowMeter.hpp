@@ -0,0 +1,39 @@
+#ifndef FLOW_METER_HPP
+#define FLOW_METER_HPP
+
+#include "driver/pulse_cnt.h"
+#include "esp_log.h"
+
+#include <cstdint>
+#include <string_view>
+
+namespace autflr {
+    /**
+     * Hall-effect flow sensor counted by the PCNT peripheral, so pulses cost no interrupts.
+     */
+    class FlowMeter {
+    public:
+        FlowMeter(gpio_num_t pin, uint32_t pulsesPerLitre);
+        ~FlowMeter();
+
+        FlowMeter(const FlowMeter&) = delete;
+        FlowMeter& operator=(const FlowMeter&) = delete;
+
+        void start() const;
+        void stop() const;
+        uint32_t getPulses() const;
+        inline uint32_t getVolumeMl() const {
+            return static_cast<uint64_t>(getPulses()) * 1000 / mPulsesPerLitre;
+        }
+
+    private:
+        pcnt_unit_handle_t mUnit{nullptr};
+        pcnt_channel_handle_t mChannel{nullptr};
+        uint32_t mPulsesPerLitre;
+        static constexpr int HIGH_LIMIT = 32767; // The accumulator extends the 16-bit counter past this.
+        static constexpr uint32_t MAX_GLITCH_NS = 1000;
+        static constexpr std::string_view TAG = "[FLOW METER]";
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,198 @@
+#ifndef I2C_BUS_MANAGER_HPP
+#define I2C_BUS_MANAGER_HPP
+
+#include "Board.hpp"
+
+#include "driver/i2c_master.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "sdkconfig.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace autflr {
+    constexpr uint8_t I2C_BUS_COUNT = I2C_BUSES.size();
+    constexpr size_t I2C_MAX_PAYLOAD = 64; // Longer writes are split into several transactions.
+    constexpr uint8_t I2C_FIRST_ADDRESS = 0x08;
+    constexpr uint8_t I2C_LAST_ADDRESS = 0x77;
+    constexpr UBaseType_t I2C_FLUSH_NOTIFY_INDEX = 0;
+
+    /**
+     * Called from the bus worker task once the transaction is on the wire.
+     */
+    using I2cCompletion = void (*)(esp_err_t result, void* arg);
+
+    /**
+     * Called from the bus worker task with the bytes read. The buffer belongs to the worker and is only
+     * valid during the call, copy what is needed.
+     */
+    using I2cReadCompletion = void (*)(esp_err_t result, const uint8_t* data, size_t length, void* arg);
+
+    struct I2cDeviceStats {
+        uint32_t transactions;
+        uint32_t errors;
+        uint64_t totalLatencyUs; // From queueing to completion.
+        uint32_t maxLatencyUs;
+    };
+
+    class I2cDevice {
+    public:
+        I2cDevice(i2c_master_dev_handle_t handle, QueueHandle_t queue, uint8_t bus, uint8_t address);
+        ~I2cDevice();
+
+        I2cDevice(const I2cDevice&) = delete;
+        I2cDevice& operator=(const I2cDevice&) = delete;
+
+        /**
+         * @brief Queues a write without blocking on the bus. The data is copied.
+         * @param postDelayUs Time the bus stays idle after the write, for devices that need settling.
+         * @param callback Optional completion callback, called after the last chunk.
+         */
+        esp_err_t write(
+            const uint8_t* data,
+            size_t length,
+            uint32_t postDelayUs = 0,
+            I2cCompletion callback = nullptr,
+            void* arg = nullptr
+        );
+
+        /**
+         * @brief Queues a write followed by a read with a repeated start, without blocking on the bus.
+         * The write is copied, both parts must fit in one transaction.
+         * @param callback Called with the bytes read, or with the error and no data.
+         * @return ESP_ERR_INVALID_SIZE if either part is longer than I2C_MAX_PAYLOAD, ESP_ERR_INVALID_ARG
+         * without a callback or bytes to read.
+         */
+        esp_err_t writeRead(
+            const uint8_t* tx,
+            size_t txLength,
+            size_t rxLength,
+            I2cReadCompletion callback,
+            void* arg = nullptr
+        );
+
+        /**
+         * @brief Queues an idle period on the bus, ordered with the writes to this device.
+         */
+        inline esp_err_t delay(uint32_t us) {
+            return write(nullptr, 0, us);
+        }
+
+        inline const I2cDeviceStats& getStats() const {
+            return mStats;
+        }
+
+        inline uint8_t getBus() const {
+            return mBus;
+        }
+
+        inline uint8_t getAddress() const {
+            return mAddress;
+        }
+
+    private:
+        friend class I2cBusManager;
+
+        void record(esp_err_t result, uint32_t latencyUs);
+
+    private:
+        i2c_master_dev_handle_t mHandle{nullptr};
+        QueueHandle_t mQueue{nullptr};
+        uint8_t mBus;
+        uint8_t mAddress;
+        I2cDeviceStats mStats{};
+    };
+
+    /**
+     * Owns the I2C buses on the i2c_master driver. Every bus has a worker task that executes the queued
+     * transactions, so callers never wait for the wire.
+     */
+    class I2cBusManager {
+    public:
+        I2cBusManager(const I2cBusManager&) = delete;
+        I2cBusManager& operator=(const I2cBusManager&) = delete;
+
+        static I2cBusManager& getInstance() {
+            static I2cBusManager instance;
+            return instance;
+        }
+
+        /**
+         * @brief Returns the device at the address, adding it to the bus on first use.
+         * @return nullptr if the bus scan did not find the address, the bus is then rescanned on the next wake.
+         */
+        I2cDevice* getDevice(uint8_t bus, uint8_t address, uint32_t frequencyHz = 0);
+
+        /**
+         * @brief Creates a driver of the specified type for a device on bus 0.
+         * @tparam DeviceType The type of the driver to create.
+         * @param address The I2C address of the device.
+         * @param args Additional arguments required for the driver's constructor.
+         * @return A unique pointer to the created driver, nullptr if the device is absent.
+         */
+        template<typename DeviceType, typename... Args>
+        std::unique_ptr<DeviceType> createDevice(uint8_t address, Args&&... args) {
+            I2cDevice* pDevice = getDevice(0, address);
+
+            if (pDevice == nullptr) {
+                return nullptr;
+            }
+
+            return std::make_unique<DeviceType>(pDevice, std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Checks the address against the bus scan. The scan is cached in RTC memory across deep sleep.
+         */
+        bool isPresent(uint8_t bus, uint8_t address);
+
+        /**
+         * @brief Blocks until every queued transaction on every bus is done. Waits on the caller's task
+         * notification index I2C_FLUSH_NOTIFY_INDEX.
+         * @return False on timeout.
+         */
+        bool flush(TickType_t timeout);
+
+        void logStats() const;
+
+    private:
+        struct Transaction {
+            I2cDevice* device;
+            I2cCompletion callback;
+            I2cReadCompletion readCallback; // Set for writeRead(), which then reads rxLength bytes.
+            void* arg;
+            int64_t queuedAtUs;
+            uint32_t postDelayUs;
+            uint8_t length;
+            uint8_t rxLength;
+            std::array<uint8_t, I2C_MAX_PAYLOAD> data;
+        };
+
+        struct Bus {
+            i2c_master_bus_handle_t handle;
+            QueueHandle_t queue;
+            TaskHandle_t worker;
+        };
+
+        I2cBusManager() {}
+
+        Bus* getBus(uint8_t bus);
+        void scan(uint8_t bus);
+        static void runWorker(void* arg);
+        static void idle(uint32_t us);
+
+    private:
+        friend class I2cDevice;
+
+        std::array<Bus, I2C_BUS_COUNT> mBuses{};
+        std::vector<std::unique_ptr<I2cDevice>> mDevices;
+        static constexpr std::string_view TAG = "[I2C]";
+    };
+}
+
+#endif
\ No newline at end of file
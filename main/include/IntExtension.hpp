@@ -29,6 +29,15 @@ namespace autflr {
 
         return static_cast<float>(numerator) / denominator * ONE_HUNDRED_PERC;
     }
+
+    // Edge cases, checked at compile time.
+    static_assert(mapToPercentage(500, 400, 400) == 0.0f, "Empty range maps to 0%");
+    static_assert(mapToPercentage(0, 400, 820) == 0.0f, "Values below the floor are clamped");
+    static_assert(mapToPercentage(1023, 400, 820) == ONE_HUNDRED_PERC, "Values above the ceil are clamped");
+    static_assert(mapToPercentage(400, 400, 820, true) == ONE_HUNDRED_PERC, "Inverted floor maps to 100%");
+    static_assert(mapToPercentage(820, 400, 820, true) == 0.0f, "Inverted ceil maps to 0%");
+    static_assert(mapToPercentage(610, 400, 820) == 50.0f, "Middle of the range maps to 50%");
+    static_assert(mapToPercentage(0, 0, UINT16_MAX) == 0.0f, "Full range does not overflow");
 }
 
 #endif
\ No newline at end of file
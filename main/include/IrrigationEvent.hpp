@@ -10,10 +10,14 @@ namespace autflr {
     constexpr uint16_t EVENT_ID_SYNC_TIME = 0;
     constexpr uint16_t EVENT_ID_IRRIGATE = 1;
     constexpr uint16_t EVENT_ID_SETTINGS = 2;
+    constexpr uint16_t EVENT_ID_DUMP_STATS = 3;
+    constexpr uint16_t EVENT_ID_OFFLINE = 4;
 
     inline const idf::event::ESPEvent SYNC_TIME(IRRIGATION_EVENT_BASE, idf::event::ESPEventID(EVENT_ID_SYNC_TIME));
     inline const idf::event::ESPEvent IRRIGATE(IRRIGATION_EVENT_BASE, idf::event::ESPEventID(EVENT_ID_IRRIGATE));
     inline const idf::event::ESPEvent SETTINGS(IRRIGATION_EVENT_BASE, idf::event::ESPEventID(EVENT_ID_SETTINGS));
+    inline const idf::event::ESPEvent DUMP_STATS(IRRIGATION_EVENT_BASE, idf::event::ESPEventID(EVENT_ID_DUMP_STATS));
+    inline const idf::event::ESPEvent OFFLINE(IRRIGATION_EVENT_BASE, idf::event::ESPEventID(EVENT_ID_OFFLINE));
 
 }
 
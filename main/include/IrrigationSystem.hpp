@@ -1,22 +1,51 @@
 #ifndef IRRIGATION_SYSTEM_HPP
 #define IRRIGATION_SYSTEM_HPP
 
-#include "I2cDeviceFactory.hpp"
-#include "SensorFactory.hpp"
+#include "EnergyManager.hpp"
+#include "I2cBusManager.hpp"
+#include "NtpClient.hpp"
+#include "OtaManager.hpp"
+#include "Scheduler.hpp"
+#include "SpscQueue.hpp"
 #include "WiFiManager.hpp"
 
+#include "esp_timer.h"
+#include "freertos/event_groups.h"
 #include "sdkconfig.h"
 
+#include <atomic>
 #include <memory>
 #include <string_view>
 #include <functional>
 
 #if CONFIG_ENABLE_LCD
 #include "Lcd.hpp"
-#define LCD_ADDRESS 0x27
 #endif
 
 namespace autflr {
+    enum class ControlReportKind : uint8_t {
+        MEASURING,
+        READINGS,
+        LOW_WATER,
+        DONE, // Last report of a wake, the control task is gone after it.
+    };
+
+    /**
+     * What the control task tells the PRO core side, which owns the display.
+     */
+    struct ControlReport {
+        ControlReportKind kind;
+        float moisturePercent;
+        float waterPercent;
+        bool isCompleted; // DONE only.
+    };
+
+    enum class NetworkOutcome : uint8_t {
+        PENDING,
+        ONLINE, // NTP synced within the budget.
+        OFFLINE, // Wi-Fi, NTP or the budget failed first.
+    };
+
     class IrrigationSystem {
     public:
         IrrigationSystem(const IrrigationSystem&) = delete;
@@ -33,6 +62,8 @@ namespace autflr {
         IrrigationSystem();
 
         void launchWiFi() const;
+        void startNetworkBudget();
+        static void handleNetworkBudgetExpired(void* arg);
         void registerEventHandlers();
         static void handleEvent(
             void* arg,
@@ -40,29 +71,103 @@ namespace autflr {
             int32_t event_id,
             void* event_data
         );
-        void syncTime() const;
-        void irrigate() const;
-        void scheduleNextLaunch() const;
         /**
-         * Calculates the time until the next start in microseconds.
-         * @param targetHour Hour of launch.
-         * @param targetMinute Minutes of launch.
-         * @return Time to start in microseconds.
+         * Starts NTP in the background, the cycle goes on meanwhile.
+         */
+        void syncTime();
+        static void handleTimeSynced(esp_err_t result, void* arg);
+        /**
+         * @brief Decides the network outcome once. NTP and the failure paths run on different tasks.
+         * @return True for the caller that decided it, the other one must leave the network alone.
+         */
+        bool settleNetwork(NetworkOutcome outcome);
+        /**
+         * Stops the network and backs off the next attempts. The schedule then falls back to RTC time,
+         * or to CONFIG_OFFLINE_WAKE_INTERVAL_MIN if the clock was never set. If NTP won, only Wi-Fi is
+         * stopped: the budget ran out or the link dropped during the OTA check.
+         */
+        void goOffline();
+        /**
+         * @brief Stops the budget timer and Wi-Fi, and sets NETWORK_STOPPED_BIT.
+         */
+        void stopNetwork();
+        #if CONFIG_ENABLE_OTA
+            /**
+             * @brief Runs the OTA check in its own task, next to the cycle. The task stops the network when
+             * the check ends, the budget ends the check at the latest.
+             * @return False if the task could not be created.
+             */
+            bool startOtaCheck();
+            static void runOtaCheck(void* arg);
+        #endif
+        /**
+         * @brief Waits for NTP or a network failure, at most until the network budget runs out.
+         * @return True if the clock was synced on this wake.
+         */
+        bool waitForNetwork() const;
+        /**
+         * @brief Waits until Wi-Fi is stopped after a sync, at most until the network budget runs out.
+         */
+        void waitForNetworkStopped() const;
+        /**
+         * Runs the irrigation once per wake and always ends in deep sleep. Sensors and pump are handed to the
+         * control task on the APP core, the calling task shows its reports until it is done. Must not run
+         * on the event loop, Wi-Fi and NTP progress there in parallel.
+         */
+        void runCycle();
+        bool startControlTask();
+        static void runControl(void* arg);
+        /**
+         * @brief Drives the LCD from the control reports until DONE, or until the control task overruns
+         * its longest possible run.
+         * @return The control task's result, false as well if the LCD failed or DONE never came.
+         */
+        bool showReports();
+        /**
+         * @brief Queues a report for the display side, dropped if the queue is full.
          */
-        uint64_t calculateNextTime(uint16_t targetHour, uint16_t targetMinute) const;
+        void report(const ControlReport& report);
+        /**
+         * @return False if a sensor read failed. True once the irrigation decision was carried out, or
+         * when a resumed cycle had nothing left to measure.
+         */
+        bool irrigate();
+        /**
+         * Doses CONFIG_DOSE_TARGET_ML if a flow meter is present, otherwise pumps for PUMPING_TIME.
+         * Both are capped by the energy policy.
+         */
+        void runPump() const;
+        void scheduleNextLaunch(bool isCycleCompleted) const;
+        /**
+         * @brief Switches off the LCD backlight, drains the I2C queues and holds the pins for deep sleep.
+         */
+        void prepareForSleep() const;
+        static bool isClockSet();
         void openSettings() const;
+        /**
+         * @brief Logs the event loop and I2C statistics and prints the binary log.
+         */
+        void dumpStats() const;
 
     private:
         idf::event::ESPEventLoop mLoop;
 
-        I2cDeviceFactory& mI2cDeviceFactory;
-        SensorFactory& mSensorFactory;
+        I2cBusManager& mI2cBusManager;
+        EnergyManager& mEnergyManager;
         WiFiManager& mWiFiManager;
+        OtaManager& mOtaManager;
+        Scheduler& mScheduler;
+        NtpClient& mNtpClient;
+        esp_timer_handle_t mNetworkBudgetTimer{nullptr};
+        int64_t mNetworkDeadlineUs{0};
+        EventGroupHandle_t mNetworkEvents{nullptr};
+        std::atomic<NetworkOutcome> mNetworkOutcome{NetworkOutcome::PENDING};
+        SpscQueue<ControlReport, 8> mReports;
 
+        static constexpr EventBits_t TIME_SYNCED_BIT = BIT0;
+        static constexpr EventBits_t NETWORK_FAILED_BIT = BIT1;
+        static constexpr EventBits_t NETWORK_STOPPED_BIT = BIT2;
         static constexpr std::string_view TAG = "[IRRIGATION]";
-        static constexpr std::string_view SENSOR_TAG_MOISTURE = "[MOISTURE SENSOR]";
-        static constexpr std::string_view SENSOR_TAG_WATER = "[WATER SENSOR]";
-        static constexpr std::string_view NTP_TAG = "[NTP]";
     };
 }
 
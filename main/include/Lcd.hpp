@@ -1,17 +1,19 @@
 #ifndef LCD_HPP
 #define LCD_HPP
 
-#include "i2c_cxx.hpp"
+#include "I2cBusManager.hpp"
+
 #include "esp_log.h"
 
-#include <chrono>
+#include <array>
+#include <cstdint>
 #include <string>
-#include <thread>
+#include <string_view>
 
 namespace autflr {
     class Lcd {
     public:
-        Lcd(idf::I2CMaster* pMaster, uint8_t address);
+        explicit Lcd(I2cDevice* pDevice);
 
         void putCursor(uint16_t row, uint16_t col) const;
         void print(
@@ -20,25 +22,52 @@ namespace autflr {
             uint32_t col
         ) const;
         inline void clear() const {
-            sendCmd(0x01);
-            std::this_thread::sleep_for(std::chrono::milliseconds(150));
+            sendCmd(0x01, CLEAR_DELAY_US);
+        }
+
+        /**
+         * @brief Drives every expander output low, which turns the backlight off and leaves the text in place.
+         * Needs no initialized display, the next command switches the backlight back on.
+         */
+        static void switchOffBacklight(I2cDevice* pDevice);
+
+        /**
+         * @brief Splits a byte into the four PCF8574 writes of the HD44780 4-bit protocol.
+         * @param value Command or character.
+         * @param enable Control bits with the enable strobe set.
+         * @param disable Control bits with the enable strobe cleared.
+         */
+        static constexpr std::array<uint8_t, 4> encode(uint8_t value, uint8_t enable, uint8_t disable) {
+            const uint8_t highOrderBits = value & 0xF0;
+            const uint8_t lowOrderBits = static_cast<uint8_t>(value << 4);
+
+            return {
+                static_cast<uint8_t>(highOrderBits | enable),
+                static_cast<uint8_t>(highOrderBits | disable),
+                static_cast<uint8_t>(lowOrderBits | enable),
+                static_cast<uint8_t>(lowOrderBits | disable)
+            };
         }
 
     private:
         void initialize() const;
-        void sendCmd(uint8_t cmd) const;
-        void sendData(uint8_t data) const;
+        /**
+         * @brief Queues a command. The bus stays idle for postDelayUs afterwards, the caller does not wait.
+         */
+        void sendCmd(uint8_t cmd, uint32_t postDelayUs = 0) const;
+        static uint8_t cursorCmd(uint16_t row, uint32_t col);
 
     private:
-        idf::I2CMaster* mMasterPtr{nullptr};
-        idf::I2CAddress mAddress{0};
+        I2cDevice* mDevicePtr{nullptr};
+        static constexpr uint32_t CLEAR_DELAY_US = 150000;
         static constexpr uint8_t ENABLE_BIT = 0x0C;
         static constexpr uint8_t DISABLE_BIT = 0x08;
         static constexpr uint8_t ENABLE_DATA = 0x0D;
         static constexpr uint8_t DISABLE_DATA = 0x09;
+        static constexpr uint8_t BACKLIGHT_OFF = 0x00;
         static constexpr uint8_t ROW_0_OFFSET = 0x80;
         static constexpr uint8_t ROW_1_OFFSET = 0xC0;
-        constexpr static const char* TAG{"[LCD]"};
+        static constexpr std::string_view TAG = "[LCD]";
     };
 }
 
@@ -2,6 +2,7 @@
 #define MEASURE_CONSTANTS_HPP
 
 #include <cstdint>
+#include <ctime>
 #include <string_view>
 
 namespace autflr {
@@ -18,11 +19,19 @@ namespace autflr {
 
     // Time constants
     constexpr uint16_t SENSOR_WARM_UP_TIME = 10; // Time in seconds for sensor stabilization.
-    constexpr uint16_t TARGET_HOUR = 18; // Hour to start the irrigation.
-    constexpr uint16_t TARGET_MINUTES = 00; // Minutes to start the irrigation.
-    constexpr uint32_t NEXT_DAY = 24 * 60 * 60; // Next day for start the irrigation.
-    constexpr uint16_t PUMPING_TIME = 20;
-    constexpr uint16_t SNTP_TIMEOUT = 10000;
+    constexpr uint16_t PUMPING_TIME = 20; // Without a flow meter the pump time, with one the safety limit.
+    constexpr uint16_t FLOW_POLL_INTERVAL_MS = 100;
+    constexpr uint16_t NTP_ROUND_TIMEOUT = 1000; // Time in ms to wait for replies before querying again.
+    constexpr uint8_t NTP_MAX_ROUNDS = 3;
+    constexpr uint16_t NETWORK_SETTLE_TIMEOUT = 500; // Time in ms past the network budget for the OFFLINE event to land.
+    constexpr uint16_t I2C_FLUSH_TIMEOUT = 1000;
+    constexpr std::time_t MIN_VALID_TIME = 1704067200; // 2024-01-01, anything earlier means the clock was never set.
+
+    // Reset recovery
+    constexpr uint8_t CHECKPOINT_MAX_RESUMES = 3; // Resets within one cycle before it is given up.
+    constexpr uint8_t MAX_PUMP_BROWNOUTS = 3; // Brownouts while pumping before the pump is skipped.
+    constexpr int BROWNOUT_POWER_STEP = 20; // Pump power in % taken off per brownout.
+    constexpr int MIN_PUMP_POWER = 40;
 
 }
 
@@ -0,0 +1,63 @@
+#ifndef NTP_CLIENT_HPP
+#define NTP_CLIENT_HPP
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+namespace autflr {
+    constexpr size_t NTP_MAX_SERVERS = 4;
+
+    /**
+     * Called from the NTP task once the clock is stepped, or once every round went unanswered.
+     */
+    using NtpCompletion = void (*)(esp_err_t result, void* arg);
+
+    /**
+     * Minimal SNTP client. It queries every server of CONFIG_NTP_SERVERS at once over one UDP socket and
+     * steps the clock on the first valid reply, so a sync normally costs one round trip. Resolved
+     * addresses are cached in RTC memory across deep sleep.
+     */
+    class NtpClient {
+    public:
+        NtpClient(const NtpClient&) = delete;
+        NtpClient& operator=(const NtpClient&) = delete;
+
+        static NtpClient& getInstance() {
+            static NtpClient instance;
+            return instance;
+        }
+
+        /**
+         * @brief Starts the sync in its own task and returns at once. Must be called once the station has an IP.
+         * Calls after the first one are ignored.
+         */
+        void startAsync(NtpCompletion completion, void* arg);
+
+    private:
+        struct Server {
+            uint32_t address; // Network byte order, 0 if unresolved.
+            uint64_t sentAtUs;
+        };
+
+        NtpClient() = default;
+
+        static void run(void* arg);
+        esp_err_t sync();
+        size_t resolveServers(std::array<Server, NTP_MAX_SERVERS>& servers) const;
+        static uint32_t resolve(std::string_view name);
+
+    private:
+        std::atomic<bool> mIsStarted{false};
+        NtpCompletion mCompletion{nullptr};
+        void* mCompletionArg{nullptr};
+        static constexpr std::string_view TAG = "[NTP]";
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef OTA_MANAGER_HPP
+#define OTA_MANAGER_HPP
+
+#include "esp_err.h"
+#include "esp_http_client.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace autflr {
+    constexpr size_t SHA256_LENGTH = 32;
+    using Sha256Digest = std::array<uint8_t, SHA256_LENGTH>;
+
+    class OtaManager {
+    public:
+        OtaManager(const OtaManager&) = delete;
+        OtaManager& operator=(const OtaManager&) = delete;
+
+        static OtaManager& getInstance() {
+            static OtaManager instance;
+            return instance;
+        }
+
+        /**
+         * @brief Confirms a freshly installed image. Must be called only after a completed irrigation cycle,
+         * otherwise the bootloader rolls back to the previous slot on the next reset.
+         */
+        void confirmImage() const;
+
+        /**
+         * @return False while the running image waits for confirmImage(). Until then the inactive slot
+         * holds the image to roll back to, and a download must not overwrite it.
+         */
+        bool isCheckDue() const;
+
+        /**
+         * @brief Asks the OTA server for a delta against the running image and applies it to the inactive slot.
+         * Must be called only while Wi-Fi is connected. The new image boots on the next wake.
+         * @param deadlineUs esp_timer time the whole check must end by. Also caps the HTTP timeout.
+         * @return ESP_OK if an update was installed, ESP_ERR_NOT_FOUND if there is none, ESP_ERR_TIMEOUT if
+         * the deadline passed first.
+         */
+        esp_err_t checkForUpdate(int64_t deadlineUs);
+
+    private:
+        OtaManager();
+
+        esp_err_t applyPatch(esp_http_client_handle_t client, int64_t deadlineUs);
+        static esp_err_t handleHttpEvent(esp_http_client_event_t* event);
+        static esp_err_t readSource(uint8_t* buf, size_t size, int offset);
+        static esp_err_t writeTarget(const uint8_t* buf, size_t size, void* arg);
+        static std::string toHex(const Sha256Digest& digest);
+        static bool fromHex(std::string_view hex, Sha256Digest& digest);
+
+    private:
+        const esp_partition_t* mRunningPartition{nullptr};
+        Sha256Digest mExpectedDigest{};
+        bool mHasExpectedDigest{false};
+        static const esp_partition_t* sSourcePartition; // Delta reader callback carries no user data.
+        static constexpr std::string_view TARGET_DIGEST_HEADER = "X-Target-SHA256";
+        static constexpr std::string_view TAG = "[OTA]";
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef PUMP_HPP
+#define PUMP_HPP
+
+#include "driver/ledc.h"
+#include "esp_log.h"
+
+#include <cstdint>
+#include <string_view>
+
+namespace autflr {
+    /**
+     * Pump driven through LEDC PWM. The duty is ramped up in hardware on start to limit the inrush current.
+     */
+    class Pump {
+    public:
+        Pump(gpio_num_t pin, uint32_t frequencyHz);
+        ~Pump();
+
+        Pump(const Pump&) = delete;
+        Pump& operator=(const Pump&) = delete;
+
+        /**
+         * @brief Ramps the duty from zero up to the given power without blocking.
+         * @param softStartMs Duration of the ramp.
+         * @param powerPercent Duty at the end of the ramp.
+         */
+        void start(uint32_t softStartMs, uint8_t powerPercent = 100) const;
+        void stop() const;
+
+    private:
+        static constexpr ledc_mode_t SPEED_MODE = LEDC_LOW_SPEED_MODE;
+        static constexpr ledc_timer_t TIMER = LEDC_TIMER_0;
+        static constexpr ledc_channel_t CHANNEL = LEDC_CHANNEL_0;
+        static constexpr ledc_timer_bit_t RESOLUTION = LEDC_TIMER_10_BIT;
+        static constexpr uint32_t MAX_DUTY = (1U << RESOLUTION) - 1;
+        static constexpr std::string_view TAG = "[PUMP]";
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <string_view>
+#include <vector>
+
+namespace autflr {
+    constexpr uint8_t ALL_WEEKDAYS = 0x7F; // Bit 0 is Sunday, as in tm_wday.
+    constexpr uint16_t MINUTES_PER_DAY = 24 * 60;
+    constexpr uint16_t DAYS_PER_WEEK = 7;
+
+    struct ScheduleSlot {
+        uint16_t minuteOfDay;
+        uint8_t weekdays;
+    };
+
+    struct BlackoutWindow {
+        uint16_t startMinute;
+        uint16_t endMinute; // Exclusive. A window ending before it starts runs past midnight.
+        uint8_t weekdays; // Days the window starts on.
+    };
+
+    class Scheduler {
+    public:
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        static Scheduler& getInstance() {
+            static Scheduler instance;
+            return instance;
+        }
+
+        /**
+         * @brief Applies the time zone and parses the schedule. The TZ string is parsed here only once.
+         * @param timezone POSIX TZ string, e.g. "CET-1CEST,M3.5.0,M10.5.0/3".
+         * @param slots Cron-like "MINUTE HOUR WEEKDAYS" entries separated by ';', e.g. "0 7 1-5;30 18 *".
+         * @param blackouts "HH:MM-HH:MM WEEKDAYS" entries separated by ';', e.g. "12:00-15:00 *".
+         * @return False if no valid slot is left, in which case the default slot is used.
+         */
+        bool configure(std::string_view timezone, std::string_view slots, std::string_view blackouts);
+
+        /**
+         * @brief Finds the nearest slot after now, in O(number of slots) with a single mktime call.
+         * Blackout windows are folded into the slots by configure(), so they cost nothing here.
+         */
+        std::time_t nextFireTime(std::time_t now) const;
+
+        /**
+         * @brief Time until the next slot, ready to be passed to esp_deep_sleep().
+         * @return Time to start in microseconds.
+         */
+        uint64_t microsecondsUntilNext(std::time_t now) const;
+
+    private:
+        Scheduler();
+
+        std::time_t nextFireTime(std::time_t now, uint16_t minDayOffset) const;
+        static bool parseSlot(std::string_view entry, ScheduleSlot& slot);
+        static bool parseBlackout(std::string_view entry, BlackoutWindow& window);
+        static bool parseWeekdays(std::string_view field, uint8_t& weekdays);
+        static bool parseClock(std::string_view field, uint16_t& minuteOfDay);
+        static uint8_t blackedOutDays(const ScheduleSlot& slot, const BlackoutWindow& window);
+
+    private:
+        std::vector<ScheduleSlot> mSlots;
+        static constexpr ScheduleSlot DEFAULT_SLOT{18 * 60, ALL_WEEKDAYS};
+        static constexpr std::string_view TAG = "[SCHEDULER]";
+    };
+}
+
+#endif
\ No newline at end of file
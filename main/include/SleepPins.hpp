@@ -0,0 +1,26 @@
+#ifndef SLEEP_PINS_HPP
+#define SLEEP_PINS_HPP
+
+namespace autflr {
+    /**
+     * Pin state across deep sleep. The rails of the board description are held at their sleep level and
+     * every other RTC pin is isolated, so nothing floats or back-powers a load while the chip sleeps.
+     */
+    class SleepPins {
+    public:
+        SleepPins() = delete;
+
+        /**
+         * @brief Holds the rails and isolates the unused RTC pins. Must be the last step before esp_deep_sleep().
+         */
+        static void hold();
+
+        /**
+         * @brief Hands the rails back to the digital GPIO matrix at the level they slept in, then drops the holds.
+         * Must run on wake before any rail is driven.
+         */
+        static void release();
+    };
+}
+
+#endif
\ No newline at end of file
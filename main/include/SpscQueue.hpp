@@ -0,0 +1,112 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace autflr {
+    /**
+     * Notification slot used by the queue wakeups. Index 0 stays with plain xTaskNotifyGive() users such as
+     * I2cBusManager::flush(), which count notifications and must not see the queue's.
+     */
+    constexpr UBaseType_t SPSC_NOTIFY_INDEX = 1;
+    static_assert(
+        configTASK_NOTIFICATION_ARRAY_ENTRIES > SPSC_NOTIFY_INDEX,
+        "Set CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES to 2 or more"
+    );
+
+    /**
+     * Lock-free ring buffer for exactly one producer and one consumer task, which may run on different
+     * cores. Neither side ever blocks the other, a consumer waiting in pop() is woken by a task notification.
+     * @tparam T Trivially copyable item, copied in and out.
+     * @tparam Capacity Power of two.
+     */
+    template<typename T, size_t Capacity>
+    class SpscQueue {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        SpscQueue() = default;
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        /**
+         * @brief Binds the task that pops, so pushes can wake it. Must be set before the producer starts.
+         */
+        void setConsumer(TaskHandle_t consumer) {
+            mConsumer.store(consumer, std::memory_order_release);
+        }
+
+        /**
+         * @brief Producer side. Never blocks.
+         * @return False if the queue is full, the item is not stored.
+         */
+        bool push(const T& item) {
+            const size_t tail = mTail.load(std::memory_order_relaxed);
+
+            if (tail - mHead.load(std::memory_order_acquire) == Capacity) {
+                return false;
+            }
+
+            mItems[tail & MASK] = item;
+            mTail.store(tail + 1, std::memory_order_release);
+            if (const TaskHandle_t consumer = mConsumer.load(std::memory_order_acquire)) {
+                xTaskNotifyGiveIndexed(consumer, SPSC_NOTIFY_INDEX);
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Consumer side. Never blocks.
+         * @return False if the queue is empty.
+         */
+        bool tryPop(T& item) {
+            const size_t head = mHead.load(std::memory_order_relaxed);
+
+            if (head == mTail.load(std::memory_order_acquire)) {
+                return false;
+            }
+
+            item = mItems[head & MASK];
+            mHead.store(head + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        /**
+         * @brief Consumer side. Waits up to timeout for an item, only callable from the consumer task.
+         * @return False on timeout.
+         */
+        bool pop(T& item, TickType_t timeout) {
+            TimeOut_t timeOut;
+            vTaskSetTimeOutState(&timeOut);
+
+            // A notification left over from an item already popped only costs one more check, the wait
+            // after it gets what is left of the timeout.
+            while (!tryPop(item)) {
+                if (xTaskCheckForTimeOut(&timeOut, &timeout) == pdTRUE) {
+                    return false;
+                }
+                ulTaskNotifyTakeIndexed(SPSC_NOTIFY_INDEX, pdTRUE, timeout);
+            }
+
+            return true;
+        }
+
+    private:
+        static constexpr size_t MASK = Capacity - 1;
+
+        std::array<T, Capacity> mItems{};
+        // Free-running counters, their difference is the fill level even across wrap-around.
+        std::atomic<size_t> mHead{0};
+        std::atomic<size_t> mTail{0};
+        std::atomic<TaskHandle_t> mConsumer{nullptr};
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef STATISTICS_HPP
+#define STATISTICS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace autflr {
+    constexpr size_t HISTOGRAM_BUCKETS = 8;
+    // Upper bounds of the buckets in microseconds. The last bucket collects everything above the last bound.
+    constexpr std::array<uint32_t, HISTOGRAM_BUCKETS - 1> HISTOGRAM_BOUNDS_US = {
+        100, 1'000, 10'000, 50'000, 100'000, 1'000'000, 10'000'000
+    };
+
+    struct Histogram {
+        std::array<uint32_t, HISTOGRAM_BUCKETS> counts;
+        uint32_t maxUs;
+
+        void record(uint32_t us) {
+            size_t bucket = 0;
+
+            while (bucket < HISTOGRAM_BOUNDS_US.size() && us > HISTOGRAM_BOUNDS_US[bucket]) {
+                ++bucket;
+            }
+            ++counts[bucket];
+            maxUs = us > maxUs ? us : maxUs;
+        }
+    };
+
+    enum class EventSource : uint8_t {
+        IRRIGATION,
+        WIFI,
+        IP,
+        COUNT
+    };
+    constexpr size_t EVENT_SOURCE_COUNT = static_cast<size_t>(EventSource::COUNT);
+
+    struct EventLoopStats {
+        std::array<Histogram, EVENT_SOURCE_COUNT> latency; // Post-to-dispatch.
+        std::array<Histogram, EVENT_SOURCE_COUNT> duration; // Handler run time.
+        std::array<uint32_t, EVENT_SOURCE_COUNT> overBudget;
+        uint16_t queueHighWater;
+    };
+
+    struct CycleStats {
+        uint32_t pumpTimeMs;
+        uint32_t volumeMl; // Zero without a flow meter.
+        uint32_t flowRateMlPerMin;
+    };
+
+    /**
+     * Statistics kept in RTC slow memory. They survive deep sleep and are cleared on power-on.
+     */
+    struct PersistentStats {
+        uint32_t wakeCount;
+        EventLoopStats eventLoop;
+        CycleStats cycle; // Last irrigation cycle.
+    };
+
+    PersistentStats& persistentStats();
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifndef STRING_EXTENSION_HPP
+#define STRING_EXTENSION_HPP
+
+#include <string_view>
+
+namespace autflr {
+    /**
+     * @return The text without leading and trailing spaces and tabs.
+     */
+    constexpr std::string_view trim(std::string_view text) {
+        const auto first = text.find_first_not_of(" \t");
+
+        if (first == std::string_view::npos) {
+            return {};
+        }
+
+        return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+    }
+
+    static_assert(trim(" \t0 7 1-5 ") == "0 7 1-5", "Both ends are trimmed");
+    static_assert(trim(" \t ").empty(), "Blank text trims to nothing");
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef WAKE_STUB_HPP
+#define WAKE_STUB_HPP
+
+#include <cstdint>
+
+namespace autflr {
+    /**
+     * Deep-sleep wake stub. It runs from RTC fast memory before the bootloader and puts the chip back
+     * to sleep on wakes with nothing to do, so the full app boots only when work is due.
+     */
+    class WakeStub {
+    public:
+        WakeStub() = delete;
+
+        /**
+         * @brief Splits a long sleep into CONFIG_WAKE_STUB_INTERVAL_MIN steps handled by the stub alone.
+         * @param sleepUs Time until the next scheduled run.
+         * @return Duration of the first sleep, to be passed to esp_deep_sleep().
+         */
+        static uint64_t arm(uint64_t sleepUs);
+
+        /**
+         * @brief Number of wakes the stub handled without booting the app, since power-on.
+         */
+        static uint32_t getSkippedWakes();
+    };
+}
+
+#endif
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef WIFI_MANAGER_HPP
 #define WIFI_MANAGER_HPP
 
+#include "BinaryLog.hpp"
+#include "EventLoopMonitor.hpp"
 #include "IrrigationEvent.hpp"
 
 #include "esp_log.h"
@@ -58,11 +60,15 @@ namespace autflr {
             esp_wifi_connect();
         }
 
+        inline void stop() const {
+            esp_wifi_stop();
+        }
+
         inline void reconnect() {
             if (mRetryNum < WIFI_MAXIMUM_RETRY) {
                 connect();
                 mRetryNum++;
-                ESP_LOGI(TAG.data(), "retry to connect to the AP");
+                AFLR_LOGI(TAG.data(), "retry to connect to the AP");
             }
         }
 
@@ -91,6 +97,7 @@ namespace autflr {
                     saveCredentials(ssid, bssid);
                 }
 
+                // The SSID is a runtime string, which the binary log cannot keep.
                 ESP_LOGI(TAG.data(), "Configuring Wi-Fi with SSID: %s", ssid.c_str());
                 ESP_ERROR_CHECK(esp_netif_init());
                 esp_netif_create_default_wifi_sta();
@@ -102,7 +109,7 @@ namespace autflr {
 
     private:
         WiFiManager() {
-            ESP_LOGI(TAG.data(), "Initializing WiFi...");
+            AFLR_LOGI(TAG.data(), "Initializing WiFi...");
             registerEventHandlers();
         }
 
@@ -111,7 +118,7 @@ namespace autflr {
             std::unique_ptr<nvs::NVSHandle> handler = nvs::open_nvs_handle("storage", NVS_READWRITE, &ret);
 
             if (ret != ESP_OK) {
-                ESP_LOGE(TAG.data(), "Failed to open NVS: %s", esp_err_to_name(ret));
+                AFLR_LOGE(TAG.data(), "Failed to open NVS: %s", esp_err_to_name(ret));
                 return std::make_unique<WiFiCredentials>();
             } else {
                 char ssid[MAX_SSID_LENGTH] = {0};
@@ -122,10 +129,10 @@ namespace autflr {
                 if ((ret = handler->get_string(WIFI_SSID.c_str(), ssid, ssidLen)) != ESP_OK
                     || (ret = handler->get_string(WIFI_BSSID.c_str(), bssid, bssidLen)) != ESP_OK
                 ) {
-                    ESP_LOGW(TAG.data(), "No Wi-Fi credentials found: %s", esp_err_to_name(ret));
+                    AFLR_LOGW(TAG.data(), "No Wi-Fi credentials found: %s", esp_err_to_name(ret));
                     return std::make_unique<WiFiCredentials>(true, "", "");
                 } else {
-                    ESP_LOGI(TAG.data(), "Wi-Fi credentials found.");
+                    AFLR_LOGI(TAG.data(), "Wi-Fi credentials found.");
                     return std::make_unique<WiFiCredentials>(true, std::string(ssid, ssidLen), std::string(bssid, bssidLen));
                 }
             }
@@ -136,17 +143,17 @@ namespace autflr {
             std::unique_ptr<nvs::NVSHandle> handler = nvs::open_nvs_handle("storage", NVS_READWRITE, &ret);
 
             if (ret != ESP_OK) {
-                ESP_LOGE(TAG.data(), "Failed to open NVS handle: %s", esp_err_to_name(ret));
+                AFLR_LOGE(TAG.data(), "Failed to open NVS handle: %s", esp_err_to_name(ret));
                 return;
             }
             if ((ret = handler->set_string(WIFI_SSID.c_str(), ssid.c_str())) != ESP_OK) {
-                ESP_LOGE(TAG.data(), "Failed to save SSID: %s", esp_err_to_name(ret));
+                AFLR_LOGE(TAG.data(), "Failed to save SSID: %s", esp_err_to_name(ret));
             }
             if ((ret = handler->set_string(WIFI_BSSID.c_str(), bssid.c_str())) != ESP_OK) {
-                ESP_LOGE(TAG.data(), "Failed to save BSSID: %s", esp_err_to_name(ret));
+                AFLR_LOGE(TAG.data(), "Failed to save BSSID: %s", esp_err_to_name(ret));
             }
             if ((ret = handler->commit()) != ESP_OK) {
-                ESP_LOGE(TAG.data(), "Failed to commit changes: %s", esp_err_to_name(ret));
+                AFLR_LOGE(TAG.data(), "Failed to commit changes: %s", esp_err_to_name(ret));
             }
         }
 
@@ -155,7 +162,7 @@ namespace autflr {
                 esp_event_handler_register(
                     WIFI_EVENT,
                     ESP_EVENT_ANY_ID,
-                    &WiFiManager::handleEvent,
+                    &EventLoopMonitor::dispatch<&WiFiManager::handleEvent>,
                     this
                 )
             );
@@ -163,7 +170,7 @@ namespace autflr {
                 esp_event_handler_register(
                     IP_EVENT,
                     IP_EVENT_STA_GOT_IP,
-                    &WiFiManager::handleEvent,
+                    &EventLoopMonitor::dispatch<&WiFiManager::handleEvent>,
                     this
                 )
             );
@@ -173,7 +180,7 @@ namespace autflr {
             auto* manager = static_cast<WiFiManager*>(arg);
 
             if (manager == nullptr) {
-                ESP_LOGE(TAG.data(), "manager is null");
+                AFLR_LOGE(TAG.data(), "manager is null");
                 return;
             }
 
@@ -184,26 +191,19 @@ namespace autflr {
                         break;
                     case WIFI_EVENT_STA_DISCONNECTED:
                         if (manager->getRetryNum() < WIFI_MAXIMUM_RETRY) {
-                            manager->connect();
+                            manager->reconnect();
                         } else {
-                            ESP_LOGE(TAG.data(),"connect to the AP fail");
+                            AFLR_LOGE(TAG.data(),"connect to the AP fail");
+                            ESP_ERROR_CHECK(EventLoopMonitor::post(OFFLINE));
                         }
                         break;
                 }
             } else if (base == IP_EVENT && id == IP_EVENT_STA_GOT_IP) {
                 ip_event_got_ip_t* gotIpEvent = static_cast<ip_event_got_ip_t*>(data);
 
-                ESP_LOGI(TAG.data(), "got ip:" IPSTR, IP2STR(&gotIpEvent->ip_info.ip));
+                AFLR_LOGI(TAG.data(), "got ip:" IPSTR, IP2STR(&gotIpEvent->ip_info.ip));
                 manager->resetRetry();
-                ESP_ERROR_CHECK(
-                    esp_event_post(
-                        SYNC_TIME.base,
-                        SYNC_TIME.id.get_id(),
-                        nullptr,
-                        0,
-                        portMAX_DELAY
-                    )
-                );
+                ESP_ERROR_CHECK(EventLoopMonitor::post(SYNC_TIME));
             }
         }
 
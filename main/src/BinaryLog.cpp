@@ -0,0 +1,121 @@
+#include "BinaryLog.hpp"
+
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+
+#include <cstdio>
+#include <ctime>
+#include <memory>
+
+// The buffer size option exists only with the binary log on, the text log needs none of this.
+#if CONFIG_ENABLE_BINARY_LOG
+namespace autflr {
+    namespace {
+        constexpr uint32_t RING_MAGIC = 0xB10C0001;
+        constexpr size_t HEADER_WORDS = 3; // Format address, level and size, RTC time.
+        constexpr size_t CAPACITY = CONFIG_BINARY_LOG_WORDS;
+
+        struct Ring {
+            uint32_t magic;
+            uint32_t head; // Next word to write.
+            uint32_t tail; // First word of the oldest record.
+            uint32_t used;
+            uint32_t dropped; // Records overwritten before a flush.
+            uint32_t words[CAPACITY];
+        };
+
+        portMUX_TYPE sLock = portMUX_INITIALIZER_UNLOCKED;
+    }
+
+    // Not cleared on deep sleep or software resets, so the log of a crashed cycle can still be flushed.
+    RTC_NOINIT_ATTR static Ring sRing;
+
+    static bool isRingValid() {
+        return sRing.magic == RING_MAGIC && sRing.head < CAPACITY && sRing.tail < CAPACITY && sRing.used <= CAPACITY;
+    }
+
+    static size_t recordSize(size_t start) {
+        return HEADER_WORDS + (sRing.words[(start + 1) % CAPACITY] & 0xFF);
+    }
+
+    void BinaryLog::append(esp_log_level_t level, const char* format, const uint32_t* args, size_t argWords) {
+        const size_t size = HEADER_WORDS + argWords;
+
+        if (size > CAPACITY || argWords > 0xFF) {
+            return;
+        }
+
+        const uint32_t header[HEADER_WORDS] = {
+            static_cast<uint32_t>(reinterpret_cast<uintptr_t>(format)),
+            static_cast<uint32_t>(level) << 8 | static_cast<uint32_t>(argWords),
+            static_cast<uint32_t>(std::time(nullptr)),
+        };
+
+        portENTER_CRITICAL_SAFE(&sLock);
+        if (!isRingValid()) {
+            sRing = {};
+            sRing.magic = RING_MAGIC;
+        }
+        while (CAPACITY - sRing.used < size) {
+            const size_t oldest = recordSize(sRing.tail);
+
+            sRing.tail = (sRing.tail + oldest) % CAPACITY;
+            sRing.used -= oldest;
+            ++sRing.dropped;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            sRing.words[(sRing.head + i) % CAPACITY] = i < HEADER_WORDS ? header[i] : args[i - HEADER_WORDS];
+        }
+        sRing.head = (sRing.head + size) % CAPACITY;
+        sRing.used += size;
+        portEXIT_CRITICAL_SAFE(&sLock);
+    }
+
+    void BinaryLog::flush() {
+        // Records are copied out under the lock and printed without it, writers never wait on the UART.
+        auto snapshot = std::make_unique<uint32_t[]>(CAPACITY);
+        size_t used = 0;
+        uint32_t dropped = 0;
+
+        portENTER_CRITICAL_SAFE(&sLock);
+        if (isRingValid()) {
+            used = sRing.used;
+            dropped = sRing.dropped;
+            for (size_t i = 0; i < used; ++i) {
+                snapshot[i] = sRing.words[(sRing.tail + i) % CAPACITY];
+            }
+            sRing.tail = sRing.head;
+            sRing.used = 0;
+            sRing.dropped = 0;
+        }
+        portEXIT_CRITICAL_SAFE(&sLock);
+
+        if (used == 0 && dropped == 0) {
+            return;
+        }
+
+        std::printf("#BL dropped %lu\n", dropped);
+        for (size_t start = 0; start + HEADER_WORDS <= used;) {
+            const size_t size = HEADER_WORDS + (snapshot[start + 1] & 0xFF);
+
+            std::printf("#BL");
+            for (size_t i = start; i < start + size && i < used; ++i) {
+                std::printf(" %08lx", snapshot[i]);
+            }
+            std::printf("\n");
+            start += size;
+        }
+        std::fflush(stdout);
+    }
+
+    uint8_t BinaryLog::getUsedPercent() {
+        portENTER_CRITICAL_SAFE(&sLock);
+        const size_t used = isRingValid() ? sRing.used : 0;
+        portEXIT_CRITICAL_SAFE(&sLock);
+
+        return static_cast<uint8_t>(used * 100 / CAPACITY);
+    }
+
+}
+#endif
\ No newline at end of file
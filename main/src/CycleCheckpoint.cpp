@@ -0,0 +1,144 @@
+#include "CycleCheckpoint.hpp"
+#include "BinaryLog.hpp"
+#include "MeasureConstants.hpp"
+
+#include "esp_attr.h"
+#include "esp_rom_crc.h"
+
+#include <cstddef>
+#include <string_view>
+
+namespace autflr {
+    namespace {
+        struct Checkpoint {
+            uint32_t magic;
+            CyclePhase phase;
+            uint8_t resumes; // Resets within the current cycle.
+            uint8_t brownouts;
+            uint8_t resetReason;
+            uint32_t pumpElapsedMs;
+            uint32_t deliveredMl;
+            uint32_t crc; // Over every field above.
+        };
+
+        constexpr uint32_t CHECKPOINT_MAGIC = 0xC7C1E001;
+        constexpr std::string_view TAG = "[CHECKPOINT]";
+
+        bool sIsResuming = false;
+    }
+
+    // Not cleared on watchdog, panic or brownout resets. Power-on leaves garbage, which fails the CRC.
+    RTC_NOINIT_ATTR static Checkpoint sCheckpoint;
+
+    static uint32_t checksum() {
+        return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&sCheckpoint), offsetof(Checkpoint, crc));
+    }
+
+    static void save() {
+        sCheckpoint.crc = checksum();
+    }
+
+    static void clearPump() {
+        sCheckpoint.pumpElapsedMs = 0;
+        sCheckpoint.deliveredMl = 0;
+    }
+
+    static bool isInterrupted(esp_reset_reason_t reason) {
+        switch (reason) {
+            case ESP_RST_BROWNOUT:
+            case ESP_RST_PANIC:
+            case ESP_RST_INT_WDT:
+            case ESP_RST_TASK_WDT:
+            case ESP_RST_WDT:
+            case ESP_RST_SW:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void CycleCheckpoint::restore() {
+        const esp_reset_reason_t reason = esp_reset_reason();
+
+        if (sCheckpoint.magic != CHECKPOINT_MAGIC || sCheckpoint.crc != checksum()) {
+            AFLR_LOGI(TAG.data(), "No valid checkpoint, starting a new cycle");
+            sCheckpoint = {};
+            sCheckpoint.magic = CHECKPOINT_MAGIC;
+        }
+
+        sIsResuming = sCheckpoint.phase != CyclePhase::IDLE && isInterrupted(reason);
+        sCheckpoint.resetReason = static_cast<uint8_t>(reason);
+
+        if (sIsResuming) {
+            ++sCheckpoint.resumes;
+            if (reason == ESP_RST_BROWNOUT && sCheckpoint.phase == CyclePhase::PUMPING) {
+                ++sCheckpoint.brownouts;
+            }
+            AFLR_LOGW(
+                TAG.data(),
+                "Reset %d in phase %u, resume #%u, %lu ms pumped, %lu ml delivered, %u brownout(s)",
+                reason,
+                static_cast<unsigned>(sCheckpoint.phase),
+                sCheckpoint.resumes,
+                sCheckpoint.pumpElapsedMs,
+                sCheckpoint.deliveredMl,
+                sCheckpoint.brownouts
+            );
+            if (sCheckpoint.resumes > CHECKPOINT_MAX_RESUMES) {
+                AFLR_LOGE(TAG.data(), "Cycle keeps resetting, giving up on it");
+                sCheckpoint.phase = CyclePhase::SCHEDULING;
+            }
+        } else {
+            // Power-on or deep sleep wake, nothing to resume. A cycle that never completed leaves its pump
+            // progress behind, which must not count against this one.
+            sCheckpoint.phase = CyclePhase::IDLE;
+            clearPump();
+        }
+        save();
+    }
+
+    bool CycleCheckpoint::isResuming() {
+        return sIsResuming;
+    }
+
+    CyclePhase CycleCheckpoint::getPhase() {
+        return sCheckpoint.phase;
+    }
+
+    void CycleCheckpoint::enter(CyclePhase phase) {
+        if (phase == CyclePhase::MEASURING) {
+            clearPump(); // A new measurement decides afresh, nothing was pumped for it yet.
+        }
+        sCheckpoint.phase = phase;
+        save();
+    }
+
+    void CycleCheckpoint::recordPump(uint32_t elapsedMs, uint32_t deliveredMl) {
+        sCheckpoint.pumpElapsedMs = elapsedMs;
+        sCheckpoint.deliveredMl = deliveredMl;
+        save();
+    }
+
+    uint32_t CycleCheckpoint::getPumpElapsedMs() {
+        return sCheckpoint.pumpElapsedMs;
+    }
+
+    uint32_t CycleCheckpoint::getDeliveredMl() {
+        return sCheckpoint.deliveredMl;
+    }
+
+    uint8_t CycleCheckpoint::getBrownouts() {
+        return sCheckpoint.brownouts;
+    }
+
+    void CycleCheckpoint::complete() {
+        if (sCheckpoint.resumes == 0 && sCheckpoint.brownouts > 0) {
+            --sCheckpoint.brownouts; // A clean cycle earns back one step of pump power.
+        }
+        sCheckpoint.phase = CyclePhase::IDLE;
+        sCheckpoint.resumes = 0;
+        clearPump();
+        save();
+    }
+
+}
\ No newline at end of file
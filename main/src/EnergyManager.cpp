@@ -0,0 +1,174 @@
+#include "EnergyManager.hpp"
+#include "AdcSensor.hpp"
+#include "BinaryLog.hpp"
+
+#include "esp_attr.h"
+#include "sdkconfig.h"
+
+#include <algorithm>
+
+namespace autflr {
+    namespace {
+        struct EnergyState {
+            uint16_t filteredMv; // 0 until the first sample.
+            EnergyLevel level;
+            uint8_t wakesSinceNetwork;
+        };
+
+        constexpr uint8_t SUPPLY_SAMPLES = 16;
+        constexpr int32_t FILTER_WEIGHT = 4; // Each wake moves the estimate by a quarter of the difference.
+    }
+
+    RTC_DATA_ATTR static EnergyState sState;
+
+    void EnergyManager::update() {
+        #if CONFIG_ENABLE_SUPPLY_MONITOR
+            uint32_t sum = 0;
+
+            for (uint8_t i = 0; i < SUPPLY_SAMPLES; ++i) {
+                sum += SupplySensor::getValueCalibrated();
+            }
+
+            const auto sampleMv = static_cast<uint16_t>(sum / SUPPLY_SAMPLES * BOARD.supplyDivider);
+
+            if (sampleMv == 0) {
+                AFLR_LOGE(TAG.data(), "Supply reading failed, keeping level %s", toString(sState.level).data());
+                mIsNetworkAllowed = sState.level == EnergyLevel::NORMAL;
+                return;
+            }
+
+            const int32_t previousMv = sState.filteredMv != 0 ? sState.filteredMv : sampleMv;
+            sState.filteredMv = static_cast<uint16_t>(previousMv + (sampleMv - previousMv) / FILTER_WEIGHT);
+
+            const auto charge = static_cast<uint8_t>(
+                std::clamp(
+                    (sState.filteredMv - CONFIG_BATTERY_EMPTY_MV) * 100 / (CONFIG_BATTERY_FULL_MV - CONFIG_BATTERY_EMPTY_MV),
+                    0,
+                    100
+                )
+            );
+            auto level = levelFor(charge);
+
+            if (level < sState.level) {
+                // Going up needs the margin, so a level is not left on the first bright wake.
+                const auto margin = static_cast<uint8_t>(std::max(charge - CONFIG_ENERGY_HYSTERESIS_PERCENT, 0));
+                level = std::min(sState.level, levelFor(margin));
+            }
+            if (level != sState.level) {
+                AFLR_LOGW(TAG.data(), "Level %s -> %s", toString(sState.level).data(), toString(level).data());
+            }
+            sState.level = level;
+
+            AFLR_LOGI(
+                TAG.data(),
+                "Supply %u mV, estimate %u mV (%+ld mV), charge %u%%, level %s",
+                sampleMv,
+                sState.filteredMv,
+                static_cast<long>(sState.filteredMv - previousMv),
+                charge,
+                toString(level).data()
+            );
+
+            switch (level) {
+                case EnergyLevel::NORMAL:
+                    mIsNetworkAllowed = true;
+                    break;
+                case EnergyLevel::SAVING:
+                    mIsNetworkAllowed = ++sState.wakesSinceNetwork >= CONFIG_ENERGY_SAVING_NETWORK_EVERY;
+                    AFLR_LOGI(
+                        TAG.data(),
+                        "LCD off, network %s (%u/%d)",
+                        mIsNetworkAllowed ? "on" : "deferred",
+                        sState.wakesSinceNetwork,
+                        CONFIG_ENERGY_SAVING_NETWORK_EVERY
+                    );
+                    break;
+                case EnergyLevel::LOW:
+                    mIsNetworkAllowed = false;
+                    AFLR_LOGW(
+                        TAG.data(),
+                        "LCD and network off, pump up to %d s, sleep at least %d min",
+                        CONFIG_ENERGY_LOW_PUMP_LIMIT_S,
+                        CONFIG_ENERGY_LOW_MIN_SLEEP_MIN
+                    );
+                    break;
+                case EnergyLevel::CUTOFF:
+                    mIsNetworkAllowed = false;
+                    AFLR_LOGW(TAG.data(), "Cycle skipped, protective sleep of %d min", CONFIG_ENERGY_CUTOFF_SLEEP_MIN);
+                    break;
+            }
+            if (mIsNetworkAllowed) {
+                sState.wakesSinceNetwork = 0;
+            }
+        #endif
+    }
+
+    EnergyLevel EnergyManager::getLevel() const {
+        return sState.level;
+    }
+
+    bool EnergyManager::isLcdAllowed() const {
+        return sState.level == EnergyLevel::NORMAL;
+    }
+
+    bool EnergyManager::isNetworkAllowed() const {
+        return mIsNetworkAllowed;
+    }
+
+    uint16_t EnergyManager::limitPumpTime(uint16_t seconds) const {
+        #if CONFIG_ENABLE_SUPPLY_MONITOR
+            if (sState.level >= EnergyLevel::LOW) {
+                return std::min<uint16_t>(seconds, CONFIG_ENERGY_LOW_PUMP_LIMIT_S);
+            }
+        #endif
+
+        return seconds;
+    }
+
+    uint64_t EnergyManager::getMinSleepUs() const {
+        #if CONFIG_ENABLE_SUPPLY_MONITOR
+            switch (sState.level) {
+                case EnergyLevel::LOW:
+                    return CONFIG_ENERGY_LOW_MIN_SLEEP_MIN * 60ULL * 1000000ULL;
+                case EnergyLevel::CUTOFF:
+                    return CONFIG_ENERGY_CUTOFF_SLEEP_MIN * 60ULL * 1000000ULL;
+                default:
+                    break;
+            }
+        #endif
+
+        return 0;
+    }
+
+    EnergyLevel EnergyManager::levelFor([[maybe_unused]] uint8_t chargePercent) {
+        #if CONFIG_ENABLE_SUPPLY_MONITOR
+            if (chargePercent <= CONFIG_ENERGY_CUTOFF_PERCENT) {
+                return EnergyLevel::CUTOFF;
+            }
+            if (chargePercent <= CONFIG_ENERGY_LOW_PERCENT) {
+                return EnergyLevel::LOW;
+            }
+            if (chargePercent <= CONFIG_ENERGY_SAVING_PERCENT) {
+                return EnergyLevel::SAVING;
+            }
+        #endif
+
+        return EnergyLevel::NORMAL;
+    }
+
+    std::string_view EnergyManager::toString(EnergyLevel level) {
+        switch (level) {
+            case EnergyLevel::NORMAL:
+                return "NORMAL";
+            case EnergyLevel::SAVING:
+                return "SAVING";
+            case EnergyLevel::LOW:
+                return "LOW";
+            case EnergyLevel::CUTOFF:
+                return "CUTOFF";
+        }
+
+        return "UNKNOWN";
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "EventLoopMonitor.hpp"
+#include "BinaryLog.hpp"
+
+#include "esp_log.h"
+#include "esp_wifi.h"
+
+#include <atomic>
+
+namespace autflr {
+    #if CONFIG_ENABLE_EVENT_MONITOR
+        static std::atomic<uint16_t> sInFlight{0};
+    #endif
+
+    esp_err_t EventLoopMonitor::post(const idf::event::ESPEvent& event) {
+        #if CONFIG_ENABLE_EVENT_MONITOR
+            const PostStamp stamp{esp_timer_get_time()};
+            auto& stats = persistentStats().eventLoop;
+            const uint16_t inFlight = ++sInFlight;
+
+            if (inFlight > stats.queueHighWater) {
+                stats.queueHighWater = inFlight;
+            }
+
+            const esp_err_t ret = esp_event_post(event.base, event.id.get_id(), &stamp, sizeof(stamp), portMAX_DELAY);
+
+            if (ret != ESP_OK) {
+                --sInFlight;
+            }
+            return ret;
+        #else
+            return esp_event_post(event.base, event.id.get_id(), nullptr, 0, portMAX_DELAY);
+        #endif
+    }
+
+    // Only dispatch() calls these, and the budget option exists only with the monitor on.
+    #if CONFIG_ENABLE_EVENT_MONITOR
+        void EventLoopMonitor::recordLatency(int64_t postedAtUs, int64_t dispatchedAtUs) {
+            --sInFlight;
+            persistentStats().eventLoop.latency[static_cast<size_t>(EventSource::IRRIGATION)].record(
+                static_cast<uint32_t>(dispatchedAtUs - postedAtUs)
+            );
+        }
+
+        void EventLoopMonitor::recordDuration(esp_event_base_t base, int32_t id, int64_t durationUs) {
+            auto& stats = persistentStats().eventLoop;
+            const auto source = static_cast<size_t>(sourceOf(base));
+
+            stats.duration[source].record(static_cast<uint32_t>(durationUs));
+            if (durationUs > CONFIG_EVENT_HANDLER_BUDGET_MS * 1000LL) {
+                ++stats.overBudget[source];
+                AFLR_LOGW(
+                    TAG.data(),
+                    "Handler for %s:%ld took %lld ms, budget is %d ms",
+                    base,
+                    id,
+                    durationUs / 1000,
+                    CONFIG_EVENT_HANDLER_BUDGET_MS
+                );
+            }
+        }
+    #endif
+
+    EventSource EventLoopMonitor::sourceOf(esp_event_base_t base) {
+        if (base == WIFI_EVENT) {
+            return EventSource::WIFI;
+        } else if (base == IP_EVENT) {
+            return EventSource::IP;
+        }
+
+        return EventSource::IRRIGATION;
+    }
+
+    void EventLoopMonitor::dump() {
+        constexpr const char* SOURCE_NAMES[EVENT_SOURCE_COUNT] = {"IRRIGATION", "WIFI", "IP"};
+        const auto& stats = persistentStats().eventLoop;
+
+        auto dumpHistogram = [](const char* name, const char* kind, const Histogram& histogram) {
+            const auto& c = histogram.counts;
+
+            AFLR_LOGI(
+                TAG.data(),
+                "%-10s %-8s <=100us:%lu <=1ms:%lu <=10ms:%lu <=50ms:%lu <=100ms:%lu <=1s:%lu <=10s:%lu >10s:%lu max:%luus",
+                name, kind, c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], histogram.maxUs
+            );
+        };
+
+        AFLR_LOGI(TAG.data(), "Wakes: %lu, queue high-water mark: %u", persistentStats().wakeCount, stats.queueHighWater);
+        for (size_t i = 0; i < EVENT_SOURCE_COUNT; ++i) {
+            if (i == static_cast<size_t>(EventSource::IRRIGATION)) {
+                dumpHistogram(SOURCE_NAMES[i], "latency", stats.latency[i]);
+            }
+            dumpHistogram(SOURCE_NAMES[i], "duration", stats.duration[i]);
+            AFLR_LOGI(TAG.data(), "%-10s over budget: %lu", SOURCE_NAMES[i], stats.overBudget[i]);
+        }
+        #if CONFIG_ESP_EVENT_LOOP_PROFILING
+            esp_event_dump(stdout);
+        #endif
+    }
+
+}
\ No newline at end of file
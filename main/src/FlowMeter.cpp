@@ -0,0 +1,59 @@
+#include "FlowMeter.hpp"
+#include "BinaryLog.hpp"
+
+namespace autflr {
+    FlowMeter::FlowMeter(gpio_num_t pin, uint32_t pulsesPerLitre) : mPulsesPerLitre{pulsesPerLitre} {
+        pcnt_unit_config_t unitConfig = {
+            .low_limit = -1,
+            .high_limit = HIGH_LIMIT,
+            .intr_priority = 0,
+            .flags = {},
+        };
+        unitConfig.flags.accum_count = 1;
+
+        const pcnt_chan_config_t channelConfig = {
+            .edge_gpio_num = pin,
+            .level_gpio_num = -1,
+            .flags = {},
+        };
+        const pcnt_glitch_filter_config_t filterConfig = {
+            .max_glitch_ns = MAX_GLITCH_NS,
+        };
+
+        ESP_ERROR_CHECK(pcnt_new_unit(&unitConfig, &mUnit));
+        ESP_ERROR_CHECK(pcnt_unit_set_glitch_filter(mUnit, &filterConfig));
+        ESP_ERROR_CHECK(pcnt_new_channel(mUnit, &channelConfig, &mChannel));
+        ESP_ERROR_CHECK(
+            pcnt_channel_set_edge_action(mChannel, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_HOLD)
+        );
+        ESP_ERROR_CHECK(pcnt_unit_add_watch_point(mUnit, HIGH_LIMIT));
+        ESP_ERROR_CHECK(pcnt_unit_enable(mUnit));
+    }
+
+    FlowMeter::~FlowMeter() {
+        pcnt_unit_stop(mUnit);
+        pcnt_unit_disable(mUnit);
+        pcnt_del_channel(mChannel);
+        pcnt_del_unit(mUnit);
+    }
+
+    void FlowMeter::start() const {
+        ESP_ERROR_CHECK(pcnt_unit_clear_count(mUnit));
+        ESP_ERROR_CHECK(pcnt_unit_start(mUnit));
+    }
+
+    void FlowMeter::stop() const {
+        ESP_ERROR_CHECK(pcnt_unit_stop(mUnit));
+    }
+
+    uint32_t FlowMeter::getPulses() const {
+        int count = 0;
+
+        if (pcnt_unit_get_count(mUnit, &count) != ESP_OK) {
+            AFLR_LOGE(TAG.data(), "Failed to read pulse count");
+        }
+
+        return static_cast<uint32_t>(count);
+    }
+
+}
\ No newline at end of file
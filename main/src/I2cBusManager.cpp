@@ -0,0 +1,321 @@
+#include "I2cBusManager.hpp"
+#include "BinaryLog.hpp"
+
+#include "esp_attr.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include "soc/soc.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace autflr {
+    namespace {
+        constexpr int TRANSFER_TIMEOUT_MS = 50;
+        constexpr int PROBE_TIMEOUT_MS = 5;
+        constexpr uint32_t WORKER_STACK_SIZE = 3072;
+        constexpr UBaseType_t WORKER_PRIORITY = 5;
+
+        struct ScanCache {
+            bool isValid;
+            std::array<uint32_t, 4> present; // Bit per 7-bit address.
+        };
+    }
+
+    // Bus scan, kept across deep sleep. A failed transaction or a missing device invalidates it, so the next
+    // wake rescans.
+    RTC_DATA_ATTR static std::array<ScanCache, I2C_BUS_COUNT> sScanCache;
+
+    I2cDevice::I2cDevice(
+        i2c_master_dev_handle_t handle,
+        QueueHandle_t queue,
+        uint8_t bus,
+        uint8_t address
+    ) : mHandle{handle}, mQueue{queue}, mBus{bus}, mAddress{address} {}
+
+    I2cDevice::~I2cDevice() {
+        i2c_master_bus_rm_device(mHandle);
+    }
+
+    esp_err_t I2cDevice::write(
+        const uint8_t* data,
+        size_t length,
+        uint32_t postDelayUs,
+        I2cCompletion callback,
+        void* arg
+    ) {
+        I2cBusManager::Transaction transaction{};
+        transaction.device = this;
+        transaction.queuedAtUs = esp_timer_get_time();
+        size_t offset = 0;
+
+        do {
+            const size_t chunk = std::min(length - offset, I2C_MAX_PAYLOAD);
+            const bool isLast = offset + chunk >= length;
+
+            if (chunk > 0) {
+                std::memcpy(transaction.data.data(), data + offset, chunk);
+            }
+            transaction.length = static_cast<uint8_t>(chunk);
+            transaction.postDelayUs = isLast ? postDelayUs : 0;
+            transaction.callback = isLast ? callback : nullptr;
+            transaction.arg = isLast ? arg : nullptr;
+
+            if (xQueueSend(mQueue, &transaction, portMAX_DELAY) != pdTRUE) {
+                return ESP_FAIL;
+            }
+            offset += chunk;
+        } while (offset < length);
+
+        return ESP_OK;
+    }
+
+    esp_err_t I2cDevice::writeRead(
+        const uint8_t* tx,
+        size_t txLength,
+        size_t rxLength,
+        I2cReadCompletion callback,
+        void* arg
+    ) {
+        if (txLength > I2C_MAX_PAYLOAD || rxLength > I2C_MAX_PAYLOAD) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        if (rxLength == 0 || callback == nullptr) {
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        I2cBusManager::Transaction transaction{};
+        transaction.device = this;
+        transaction.queuedAtUs = esp_timer_get_time();
+        transaction.readCallback = callback;
+        transaction.arg = arg;
+        transaction.length = static_cast<uint8_t>(txLength);
+        transaction.rxLength = static_cast<uint8_t>(rxLength);
+        if (txLength > 0) {
+            std::memcpy(transaction.data.data(), tx, txLength);
+        }
+
+        return xQueueSend(mQueue, &transaction, portMAX_DELAY) == pdTRUE ? ESP_OK : ESP_FAIL;
+    }
+
+    void I2cDevice::record(esp_err_t result, uint32_t latencyUs) {
+        ++mStats.transactions;
+        mStats.totalLatencyUs += latencyUs;
+        mStats.maxLatencyUs = std::max(mStats.maxLatencyUs, latencyUs);
+
+        if (result != ESP_OK) {
+            ++mStats.errors;
+            sScanCache[mBus].isValid = false;
+            AFLR_LOGW(I2cBusManager::TAG.data(), "Transfer to 0x%02X on bus %u failed: %s", mAddress, mBus, esp_err_to_name(result));
+        }
+    }
+
+    I2cDevice* I2cBusManager::getDevice(uint8_t bus, uint8_t address, uint32_t frequencyHz) {
+        auto existing = std::find_if(mDevices.begin(), mDevices.end(), [bus, address](const auto& pDevice) {
+            return pDevice->getBus() == bus && pDevice->getAddress() == address;
+        });
+
+        if (existing != mDevices.end()) {
+            return existing->get();
+        }
+
+        Bus* pBus = getBus(bus);
+
+        if (pBus == nullptr) {
+            return nullptr;
+        }
+        if (!isPresent(bus, address)) {
+            sScanCache[bus].isValid = false; // The device may have been plugged in since, look again next wake.
+            AFLR_LOGW(TAG.data(), "No device at 0x%02X on bus %u", address, bus);
+            return nullptr;
+        }
+
+        const i2c_device_config_t config = {
+            .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+            .device_address = address,
+            .scl_speed_hz = frequencyHz != 0 ? frequencyHz : I2C_BUSES[bus].frequencyHz,
+            .scl_wait_us = 0,
+            .flags = {},
+        };
+        i2c_master_dev_handle_t handle = nullptr;
+        const esp_err_t ret = i2c_master_bus_add_device(pBus->handle, &config, &handle);
+
+        if (ret != ESP_OK) {
+            AFLR_LOGE(TAG.data(), "Failed to add device 0x%02X on bus %u: %s", address, bus, esp_err_to_name(ret));
+            return nullptr;
+        }
+
+        mDevices.push_back(std::make_unique<I2cDevice>(handle, pBus->queue, bus, address));
+        return mDevices.back().get();
+    }
+
+    bool I2cBusManager::isPresent(uint8_t bus, uint8_t address) {
+        if (getBus(bus) == nullptr || address < I2C_FIRST_ADDRESS || address > I2C_LAST_ADDRESS) {
+            return false;
+        }
+        if (!sScanCache[bus].isValid) {
+            scan(bus);
+        }
+
+        return sScanCache[bus].present[address / 32] & (1U << (address % 32));
+    }
+
+    bool I2cBusManager::flush(TickType_t timeout) {
+        const TaskHandle_t caller = xTaskGetCurrentTaskHandle();
+        Transaction marker{};
+        marker.callback = [](esp_err_t, void* arg) {
+            xTaskNotifyGiveIndexed(static_cast<TaskHandle_t>(arg), I2C_FLUSH_NOTIFY_INDEX);
+        };
+        marker.arg = caller;
+        size_t pending = 0;
+
+        // A marker from an earlier flush that timed out may still give late, it must not count for this one.
+        ulTaskNotifyValueClearIndexed(nullptr, I2C_FLUSH_NOTIFY_INDEX, UINT32_MAX);
+
+        for (auto& bus : mBuses) {
+            if (bus.queue != nullptr && xQueueSend(bus.queue, &marker, timeout) == pdTRUE) {
+                ++pending;
+            }
+        }
+        TimeOut_t timeOut;
+        TickType_t remaining = timeout;
+
+        vTaskSetTimeOutState(&timeOut);
+        for (; pending > 0; --pending) {
+            if (xTaskCheckForTimeOut(&timeOut, &remaining) == pdTRUE
+                || ulTaskNotifyTakeIndexed(I2C_FLUSH_NOTIFY_INDEX, pdFALSE, remaining) == 0
+            ) {
+                AFLR_LOGW(TAG.data(), "Timed out waiting for the I2C queues to drain");
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void I2cBusManager::logStats() const {
+        for (const auto& pDevice : mDevices) {
+            const auto& stats = pDevice->getStats();
+
+            AFLR_LOGI(
+                TAG.data(),
+                "Bus %u 0x%02X: %lu transactions, %lu errors, avg %llu us, max %lu us",
+                pDevice->getBus(),
+                pDevice->getAddress(),
+                stats.transactions,
+                stats.errors,
+                stats.transactions > 0 ? stats.totalLatencyUs / stats.transactions : 0,
+                stats.maxLatencyUs
+            );
+        }
+    }
+
+    I2cBusManager::Bus* I2cBusManager::getBus(uint8_t bus) {
+        if (bus >= I2C_BUS_COUNT) {
+            AFLR_LOGE(TAG.data(), "Bus %u is not configured", bus);
+            return nullptr;
+        }
+
+        Bus& entry = mBuses[bus];
+
+        if (entry.handle != nullptr) {
+            return &entry;
+        }
+
+        i2c_master_bus_config_t config = {};
+        config.i2c_port = static_cast<i2c_port_num_t>(bus);
+        config.sda_io_num = I2C_BUSES[bus].sda;
+        config.scl_io_num = I2C_BUSES[bus].scl;
+        config.clk_source = I2C_CLK_SRC_DEFAULT;
+        config.glitch_ignore_cnt = 7;
+        config.flags.enable_internal_pullup = true;
+
+        const esp_err_t ret = i2c_new_master_bus(&config, &entry.handle);
+
+        if (ret != ESP_OK) {
+            AFLR_LOGE(TAG.data(), "Failed to initialize bus %u: %s", bus, esp_err_to_name(ret));
+            entry.handle = nullptr;
+            return nullptr;
+        }
+
+        entry.queue = xQueueCreate(CONFIG_I2C_QUEUE_DEPTH, sizeof(Transaction));
+        xTaskCreatePinnedToCore(
+            &I2cBusManager::runWorker, "i2c_worker", WORKER_STACK_SIZE, &entry, WORKER_PRIORITY, &entry.worker, PRO_CPU_NUM
+        ); // The display belongs to the PRO core, the APP core is kept for the control task.
+        AFLR_LOGI(TAG.data(), "Bus %u initialized successfully", bus);
+
+        return &entry;
+    }
+
+    void I2cBusManager::scan(uint8_t bus) {
+        auto& cache = sScanCache[bus];
+        cache.present = {};
+
+        for (uint8_t address = I2C_FIRST_ADDRESS; address <= I2C_LAST_ADDRESS; ++address) {
+            if (i2c_master_probe(mBuses[bus].handle, address, PROBE_TIMEOUT_MS) == ESP_OK) {
+                cache.present[address / 32] |= 1U << (address % 32);
+                AFLR_LOGI(TAG.data(), "Found device 0x%02X on bus %u", address, bus);
+            }
+        }
+        cache.isValid = true;
+    }
+
+    void I2cBusManager::runWorker(void* arg) {
+        auto* pBus = static_cast<Bus*>(arg);
+        Transaction transaction;
+        std::array<uint8_t, I2C_MAX_PAYLOAD> rxBuffer; // Handed to the read callbacks, one transfer at a time.
+
+        while (true) {
+            if (xQueueReceive(pBus->queue, &transaction, portMAX_DELAY) != pdTRUE) {
+                continue;
+            }
+
+            esp_err_t ret = ESP_OK;
+
+            if (transaction.rxLength > 0) {
+                ret = transaction.length > 0
+                    ? i2c_master_transmit_receive(
+                        transaction.device->mHandle,
+                        transaction.data.data(),
+                        transaction.length,
+                        rxBuffer.data(),
+                        transaction.rxLength,
+                        TRANSFER_TIMEOUT_MS
+                    )
+                    : i2c_master_receive(
+                        transaction.device->mHandle, rxBuffer.data(), transaction.rxLength, TRANSFER_TIMEOUT_MS
+                    );
+                transaction.device->record(ret, static_cast<uint32_t>(esp_timer_get_time() - transaction.queuedAtUs));
+            } else if (transaction.length > 0) {
+                ret = i2c_master_transmit(
+                    transaction.device->mHandle,
+                    transaction.data.data(),
+                    transaction.length,
+                    TRANSFER_TIMEOUT_MS
+                );
+                transaction.device->record(ret, static_cast<uint32_t>(esp_timer_get_time() - transaction.queuedAtUs));
+            }
+            idle(transaction.postDelayUs);
+            if (transaction.readCallback != nullptr) {
+                const bool isRead = ret == ESP_OK;
+                transaction.readCallback(
+                    ret, isRead ? rxBuffer.data() : nullptr, isRead ? transaction.rxLength : 0, transaction.arg
+                );
+            } else if (transaction.callback != nullptr) {
+                transaction.callback(ret, transaction.arg);
+            }
+        }
+    }
+
+    void I2cBusManager::idle(uint32_t us) {
+        constexpr uint32_t TICK_US = portTICK_PERIOD_MS * 1000;
+
+        if (us >= TICK_US) {
+            vTaskDelay((us + TICK_US - 1) / TICK_US);
+        } else if (us > 0) {
+            esp_rom_delay_us(us);
+        }
+    }
+
+}
\ No newline at end of file
@@ -1,34 +1,101 @@
 #include "IrrigationSystem.hpp"
+#include "AdcSensor.hpp"
+#include "BinaryLog.hpp"
+#include "Board.hpp"
+#include "CycleCheckpoint.hpp"
+#include "EventLoopMonitor.hpp"
+#include "FlowMeter.hpp"
 #include "IntExtension.hpp"
 #include "MeasureConstants.hpp"
+#include "Pump.hpp"
+#include "SleepPins.hpp"
+#include "WakeStub.hpp"
 
-#include "driver/rtc_io.h"
-#include "esp_netif_sntp.h"
+#include "esp_attr.h"
 #include "esp_sleep.h"
-#include "esp_sntp.h"
+#include "freertos/task.h"
+#include "gpio_cxx.hpp"
+#include "soc/soc.h"
 
+#include <algorithm>
 #include <chrono>
 #include <ctime>
+#include <format>
+#include <thread>
 
 #define WIFI_SSID CONFIG_WIFI_SSID
 #define WIFI_BSSID CONFIG_WIFI_PASSWORD
-#define SENSOR_POWER_PIN CONFIG_SENSOR_POWER_PIN
-#define PUMP_POWER_PIN CONFIG_PUMP_PIN
-#define WARNING_LED_PIN CONFIG_WARNING_LED_PIN
 
 namespace autflr {
+    namespace {
+        // Sensors and pump get the APP core to themselves, Wi-Fi, lwIP, NTP and the display stay on the PRO core.
+        #if CONFIG_FREERTOS_UNICORE
+            constexpr BaseType_t CONTROL_CORE = PRO_CPU_NUM;
+        #else
+            constexpr BaseType_t CONTROL_CORE = APP_CPU_NUM;
+        #endif
+        constexpr uint32_t CONTROL_STACK_SIZE = 6144;
+        constexpr UBaseType_t CONTROL_PRIORITY = configMAX_PRIORITIES - 5; // Below esp_timer and IPC only.
+        // Warm-up, the longest pump run with the slowest soft start, and slack for the reads and the reports.
+        constexpr uint32_t CONTROL_TIMEOUT_MS = (SENSOR_WARM_UP_TIME + PUMPING_TIME) * 1000U
+            + CONFIG_PUMP_SOFT_START_MS * (MAX_PUMP_BROWNOUTS + 1U)
+            + 5000U;
+        #if CONFIG_ENABLE_OTA
+            constexpr uint32_t OTA_STACK_SIZE = 8192; // HTTP client and the delta decoder.
+            constexpr UBaseType_t OTA_PRIORITY = 5; // With NTP, below Wi-Fi and lwIP.
+        #endif
+    }
+
+    // Network backoff, kept across deep sleep.
+    RTC_DATA_ATTR static uint8_t sNetworkFailures = 0;
+    RTC_DATA_ATTR static uint16_t sNetworkWakesToSkip = 0;
+
     IrrigationSystem::IrrigationSystem() :  mLoop{}, // Must be initialized first, and only here. Because DEFAULT event loop must be only once.
-                                            mI2cDeviceFactory{I2cDeviceFactory::getInstance()},
-                                            mSensorFactory{SensorFactory::getInstance()},
-                                            mWiFiManager{WiFiManager::getInstance()}
+                                            mI2cBusManager{I2cBusManager::getInstance()},
+                                            mEnergyManager{EnergyManager::getInstance()},
+                                            mWiFiManager{WiFiManager::getInstance()},
+                                            mOtaManager{OtaManager::getInstance()},
+                                            mScheduler{Scheduler::getInstance()},
+                                            mNtpClient{NtpClient::getInstance()},
+                                            mNetworkEvents{xEventGroupCreate()}
     {
         registerEventHandlers();
     }
 
     void IrrigationSystem::launch() {
-        ESP_LOGI(TAG.data(), "Launching Irrigation System...");
+        AFLR_LOGI(TAG.data(), "Launching Irrigation System...");
+        SleepPins::release();
+        CycleCheckpoint::restore();
+        ++persistentStats().wakeCount;
+        if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT0) {
+            openSettings();
+        }
+        mScheduler.configure(CONFIG_SCHEDULE_TIMEZONE, CONFIG_SCHEDULE_SLOTS, CONFIG_SCHEDULE_BLACKOUTS);
+        mEnergyManager.update();
+
+        if (mEnergyManager.getLevel() == EnergyLevel::CUTOFF) {
+            AFLR_LOGW(TAG.data(), "Supply below cutoff, skipping the cycle");
+            xEventGroupSetBits(mNetworkEvents, NETWORK_FAILED_BIT);
+            scheduleNextLaunch(false);
+            return;
+        }
 
-        launchWiFi();
+        if (CycleCheckpoint::isResuming() && isClockSet()) {
+            AFLR_LOGI(TAG.data(), "Resuming after a reset, RTC time is kept and the network is skipped");
+            xEventGroupSetBits(mNetworkEvents, NETWORK_FAILED_BIT);
+        } else if (!mEnergyManager.isNetworkAllowed()) {
+            AFLR_LOGI(TAG.data(), "Network deferred by the energy policy");
+            xEventGroupSetBits(mNetworkEvents, NETWORK_FAILED_BIT); // No budget timer, so no backoff either.
+        } else if (sNetworkWakesToSkip > 0) {
+            --sNetworkWakesToSkip;
+            AFLR_LOGW(TAG.data(), "Network backoff, %u wake(s) left without Wi-Fi", sNetworkWakesToSkip);
+            xEventGroupSetBits(mNetworkEvents, NETWORK_FAILED_BIT);
+        } else {
+            startNetworkBudget();
+            launchWiFi();
+        }
+
+        runCycle(); // Only the schedule at the end of the cycle waits for the time.
     }
 
     void IrrigationSystem::launchWiFi() const {
@@ -36,20 +103,47 @@ namespace autflr {
         mWiFiManager.start();
     }
 
+    void IrrigationSystem::startNetworkBudget() {
+        const esp_timer_create_args_t timerArgs = {
+            .callback = &IrrigationSystem::handleNetworkBudgetExpired,
+            .arg = this,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "network_budget",
+            .skip_unhandled_events = true,
+        };
+
+        ESP_ERROR_CHECK(esp_timer_create(&timerArgs, &mNetworkBudgetTimer));
+        ESP_ERROR_CHECK(esp_timer_start_once(mNetworkBudgetTimer, CONFIG_NETWORK_TIME_BUDGET_MS * 1000ULL));
+        mNetworkDeadlineUs = esp_timer_get_time() + CONFIG_NETWORK_TIME_BUDGET_MS * 1000LL;
+    }
+
+    void IrrigationSystem::handleNetworkBudgetExpired(void* arg) {
+        AFLR_LOGW(TAG.data(), "Network time budget of %d ms is exhausted", CONFIG_NETWORK_TIME_BUDGET_MS);
+        ESP_ERROR_CHECK(EventLoopMonitor::post(OFFLINE));
+    }
+
     void IrrigationSystem::registerEventHandlers() {
         ESP_ERROR_CHECK(
             esp_event_handler_register(
                 SYNC_TIME.base,
                 SYNC_TIME.id.get_id(),
-                &IrrigationSystem::handleEvent,
+                &EventLoopMonitor::dispatch<&IrrigationSystem::handleEvent>,
                 this
             )
         );
         ESP_ERROR_CHECK(
             esp_event_handler_register(
-                IRRIGATE.base,
-                IRRIGATE.id.get_id(),
-                &IrrigationSystem::handleEvent,
+                OFFLINE.base,
+                OFFLINE.id.get_id(),
+                &EventLoopMonitor::dispatch<&IrrigationSystem::handleEvent>,
+                this
+            )
+        );
+        ESP_ERROR_CHECK(
+            esp_event_handler_register(
+                DUMP_STATS.base,
+                DUMP_STATS.id.get_id(),
+                &EventLoopMonitor::dispatch<&IrrigationSystem::handleEvent>,
                 this
             )
         );
@@ -64,180 +158,493 @@ namespace autflr {
         auto* system = static_cast<IrrigationSystem*>(arg);
 
         if (!system) {
-            ESP_LOGE(TAG.data(), "Irrigation System is null");
+            AFLR_LOGE(TAG.data(), "Irrigation System is null");
             return;
         }
 
         if (base == IRRIGATION_EVENT_BASE) {
             if (id == SYNC_TIME.id.get_id()) {
                 system->syncTime();
-            } else if (base == IRRIGATE.base) {
-                auto* system = static_cast<IrrigationSystem*>(arg);
-                system->irrigate();
+            } else if (id == OFFLINE.id.get_id()) {
+                system->goOffline();
+            } else if (id == DUMP_STATS.id.get_id()) {
+                system->dumpStats();
             }
         }
     }
 
-    void IrrigationSystem::syncTime() const {
-        ESP_LOGI(NTP_TAG.data(), "Initializing SNTP...");
+    void IrrigationSystem::syncTime() {
+        mNtpClient.startAsync(&IrrigationSystem::handleTimeSynced, this);
+    }
 
-        esp_sntp_config_t config = ESP_NETIF_SNTP_DEFAULT_CONFIG("pool.ntp.org");
+    void IrrigationSystem::handleTimeSynced(esp_err_t result, void* arg) {
+        auto* system = static_cast<IrrigationSystem*>(arg);
 
-        esp_netif_sntp_init(&config);
-        if (esp_netif_sntp_sync_wait(pdMS_TO_TICKS(SNTP_TIMEOUT)) != ESP_OK) {
-            ESP_LOGE(NTP_TAG.data(), "Failed to update system time within 10s timeout");
-        } else {
-            ESP_ERROR_CHECK(
-                esp_event_post(
-                    IRRIGATE.base,
-                    IRRIGATE.id.get_id(),
-                    nullptr,
-                    0,
-                    portMAX_DELAY
-                )
-            );
+        if (result != ESP_OK) {
+            AFLR_LOGW(TAG.data(), "Time sync failed: %s", esp_err_to_name(result));
+            system->goOffline(); // Right here on the NTP task, a full event queue must not abort.
+            return;
+        }
+        if (!system->settleNetwork(NetworkOutcome::ONLINE)) {
+            return; // The budget ran out or Wi-Fi failed first, the network is already going down.
+        }
+
+        sNetworkFailures = 0;
+        #if CONFIG_ENABLE_OTA
+            // Right after the sync and next to the cycle, so the check gets the rest of the budget and not
+            // what the warm-up and the pump leave of it.
+            const bool isOtaStarted = system->mOtaManager.isCheckDue() && system->startOtaCheck();
+        #else
+            constexpr bool isOtaStarted = false;
+        #endif
+        if (!isOtaStarted) {
+            system->stopNetwork(); // Nothing else needs the network on this wake, the radio is the largest draw left.
         }
+        xEventGroupSetBits(system->mNetworkEvents, TIME_SYNCED_BIT);
     }
 
-    void IrrigationSystem::irrigate() const {
-        auto moistureSensor = mSensorFactory.createSensorOneShot(SENSOR_TAG_MOISTURE.data(), ADC_UNIT_1, ADC_CHANNEL_6);
+    bool IrrigationSystem::settleNetwork(NetworkOutcome outcome) {
+        NetworkOutcome expected = NetworkOutcome::PENDING;
 
-        #if CONFIG_ENABLE_WATER_SENSOR
-            auto waterSensor = mSensorFactory.createSensorOneShot(SENSOR_TAG_WATER.data(), ADC_UNIT_1, ADC_CHANNEL_7);
-        #endif
-        #if CONFIG_ENABLE_LCD
-            auto lcdDevice = mI2cDeviceFactory.createDevice<autflr::Lcd>(LCD_ADDRESS);
+        return mNetworkOutcome.compare_exchange_strong(expected, outcome);
+    }
 
-            if (!lcdDevice) {
-                ESP_LOGE(TAG.data(), "Failed to initialize LCD device.");
-                return;
+    void IrrigationSystem::goOffline() {
+        if (!settleNetwork(NetworkOutcome::OFFLINE)) {
+            if (mNetworkOutcome == NetworkOutcome::ONLINE) {
+                AFLR_LOGW(TAG.data(), "Network lost or out of time after the sync, stopping Wi-Fi");
+                mWiFiManager.stop(); // Cuts off an OTA download that is still running.
             }
+            return; // Otherwise the failure is already handled.
+        }
+
+        if (mNetworkBudgetTimer != nullptr) {
+            stopNetwork();
+            sNetworkFailures = std::min<uint8_t>(sNetworkFailures + 1, CONFIG_NETWORK_BACKOFF_MAX_EXPONENT);
+            sNetworkWakesToSkip = (1U << sNetworkFailures) - 1;
+            AFLR_LOGW(TAG.data(), "Network failure #%u, skipping Wi-Fi on the next %u wake(s)", sNetworkFailures, sNetworkWakesToSkip);
+        }
+        xEventGroupSetBits(mNetworkEvents, NETWORK_FAILED_BIT);
+    }
+
+    void IrrigationSystem::stopNetwork() {
+        esp_timer_stop(mNetworkBudgetTimer);
+        mWiFiManager.stop();
+        xEventGroupSetBits(mNetworkEvents, NETWORK_STOPPED_BIT);
+    }
+
+    #if CONFIG_ENABLE_OTA
+        bool IrrigationSystem::startOtaCheck() {
+            if (
+                xTaskCreatePinnedToCore(
+                    &IrrigationSystem::runOtaCheck,
+                    "ota",
+                    OTA_STACK_SIZE,
+                    this,
+                    OTA_PRIORITY,
+                    nullptr,
+                    PRO_CPU_NUM
+                ) != pdPASS
+            ) {
+                AFLR_LOGE(TAG.data(), "Failed to create the OTA task");
+                return false;
+            }
+
+            return true;
+        }
+
+        void IrrigationSystem::runOtaCheck(void* arg) {
+            auto* system = static_cast<IrrigationSystem*>(arg);
+
+            // Wi-Fi is still up after NTP, so the check costs no extra connection.
+            system->mOtaManager.checkForUpdate(system->mNetworkDeadlineUs);
+            system->stopNetwork();
+            vTaskDelete(nullptr);
+        }
+    #endif
+
+    bool IrrigationSystem::waitForNetwork() const {
+        const int64_t remainingMs = std::max<int64_t>(mNetworkDeadlineUs - esp_timer_get_time(), 0) / 1000;
+        const EventBits_t bits = xEventGroupWaitBits(
+            mNetworkEvents,
+            TIME_SYNCED_BIT | NETWORK_FAILED_BIT,
+            pdFALSE,
+            pdFALSE,
+            pdMS_TO_TICKS(remainingMs + NETWORK_SETTLE_TIMEOUT)
+        );
+
+        return (bits & TIME_SYNCED_BIT) != 0;
+    }
+
+    void IrrigationSystem::waitForNetworkStopped() const {
+        const int64_t remainingMs = std::max<int64_t>(mNetworkDeadlineUs - esp_timer_get_time(), 0) / 1000;
+
+        xEventGroupWaitBits(mNetworkEvents, NETWORK_STOPPED_BIT, pdFALSE, pdFALSE, pdMS_TO_TICKS(remainingMs + NETWORK_SETTLE_TIMEOUT));
+    }
+
+    void IrrigationSystem::runCycle() {
+        const bool isCompleted = startControlTask() && showReports();
+
+        CycleCheckpoint::enter(CyclePhase::SCHEDULING);
+        scheduleNextLaunch(isCompleted);
+    }
+
+    bool IrrigationSystem::startControlTask() {
+        mReports.setConsumer(xTaskGetCurrentTaskHandle());
+        if (
+            xTaskCreatePinnedToCore(
+                &IrrigationSystem::runControl,
+                "control",
+                CONTROL_STACK_SIZE,
+                this,
+                CONTROL_PRIORITY,
+                nullptr,
+                CONTROL_CORE
+            ) != pdPASS
+        ) {
+            AFLR_LOGE(TAG.data(), "Failed to create the control task");
+            return false;
+        }
+
+        return true;
+    }
+
+    void IrrigationSystem::runControl(void* arg) {
+        auto* system = static_cast<IrrigationSystem*>(arg);
+        const ControlReport done{ControlReportKind::DONE, 0.0f, 0.0f, system->irrigate()};
+
+        while (!system->mReports.push(done)) {
+            vTaskDelay(1); // Only DONE is worth waiting for, the display side sleeps without it.
+        }
+        vTaskDelete(nullptr);
+    }
 
-            lcdDevice->clear();
-            lcdDevice->print("Measuring...", 0, 0);
+    bool IrrigationSystem::showReports() {
+        bool isDisplayOk = true;
+        ControlReport report{};
+        #if CONFIG_ENABLE_LCD
+            std::unique_ptr<Lcd> lcdDevice;
         #endif
+        TimeOut_t timeOut;
+        TickType_t remaining = pdMS_TO_TICKS(CONTROL_TIMEOUT_MS);
+
+        vTaskSetTimeOutState(&timeOut);
+        while (true) {
+            if (xTaskCheckForTimeOut(&timeOut, &remaining) == pdTRUE || !mReports.pop(report, remaining)) {
+                // The rails are held low for sleep, which also stops a pump the control task left running.
+                AFLR_LOGE(TAG.data(), "Control task not done within %lu ms, scheduling anyway", CONTROL_TIMEOUT_MS);
+                return false;
+            }
 
-        if (!moistureSensor) {
-            ESP_LOGE(TAG.data(), "Failed to initialize moisture sensor.");
-            return;
+            #if CONFIG_ENABLE_LCD
+                switch (report.kind) {
+                    case ControlReportKind::MEASURING:
+                        if (!mEnergyManager.isLcdAllowed()) {
+                            AFLR_LOGI(TAG.data(), "LCD skipped by the energy policy");
+                            break;
+                        }
+                        lcdDevice = mI2cBusManager.createDevice<autflr::Lcd>(BOARD.lcdAddress);
+                        if (!lcdDevice) {
+                            AFLR_LOGE(TAG.data(), "Failed to initialize LCD device.");
+                            isDisplayOk = false;
+                            break;
+                        }
+                        lcdDevice->clear();
+                        lcdDevice->print("Measuring...", 0, 0);
+                        break;
+                    case ControlReportKind::READINGS:
+                        if (lcdDevice) {
+                            lcdDevice->print(std::format("{}{:.1f}%", "Moisture:", report.moisturePercent), 0, 0);
+                            #if CONFIG_ENABLE_WATER_SENSOR
+                                lcdDevice->print(std::format("{}{:.1f}%", "Water:", report.waterPercent), 1, 0);
+                            #endif
+                        }
+                        break;
+                    case ControlReportKind::LOW_WATER:
+                        if (lcdDevice) {
+                            lcdDevice->clear();
+                            lcdDevice->print(WARNING_MESSAGE.data(), 0, 0);
+                        }
+                        break;
+                    case ControlReportKind::DONE:
+                        break;
+                }
+            #endif
+
+            if (report.kind == ControlReportKind::DONE) {
+                return report.isCompleted && isDisplayOk;
+            }
         }
-        #if CONFIG_ENABLE_WATER_SENSOR
-            if (!waterSensor) {
-                ESP_LOGE(TAG.data(), "Failed to initialize water sensor.");
-                return;
+    }
+
+    void IrrigationSystem::report(const ControlReport& report) {
+        if (!mReports.push(report)) {
+            AFLR_LOGW(TAG.data(), "Report queue is full, the display misses an update");
+        }
+    }
+
+    bool IrrigationSystem::irrigate() {
+        if (CycleCheckpoint::isResuming()) {
+            switch (CycleCheckpoint::getPhase()) {
+                case CyclePhase::PUMPING:
+                    AFLR_LOGW(TAG.data(), "Resuming the interrupted watering");
+                    runPump();
+                    return true;
+                case CyclePhase::VERIFYING:
+                case CyclePhase::SCHEDULING:
+                    AFLR_LOGW(TAG.data(), "Watering was done before the reset, skipping to the schedule");
+                    return true;
+                default:
+                    break; // Nothing was decided yet, measure again.
             }
-        #endif
+        }
+
+        CycleCheckpoint::enter(CyclePhase::MEASURING);
+        persistentStats().cycle = {};
+        report({ControlReportKind::MEASURING, 0.0f, 0.0f, false});
 
-        auto sensorPower = std::make_unique<idf::GPIO_Output>(idf::GPIONum(SENSOR_POWER_PIN));
-        auto pumpPower = std::make_unique<idf::GPIO_Output>(idf::GPIONum(PUMP_POWER_PIN));
-        auto warningLed = std::make_unique<idf::GPIO_Output>(idf::GPIONum(WARNING_LED_PIN));
+        auto sensorPower = std::make_unique<idf::GPIO_Output>(idf::GPIONum(BOARD.sensorRail));
+        auto warningLed = std::make_unique<idf::GPIO_Output>(idf::GPIONum(BOARD.warningLed));
 
         warningLed->set_low();
         sensorPower->set_high();
         std::this_thread::sleep_for(std::chrono::seconds(SENSOR_WARM_UP_TIME)); // Sensor stabilisation.
 
-        auto moisture = moistureSensor->getValueRaw();
-        auto moistureConverted = mapToPercentage(moisture, MIN_MAP_MOISTURE, MAX_MAP_MOISTURE, true);
+        auto moisture = MoistureSensor::getValueRaw();
+        bool isRead = moisture.has_value();
         #if CONFIG_ENABLE_WATER_SENSOR
-            auto waterLevel = waterSensor->getValueRaw();
-            auto waterLevelConverted = mapToPercentage(waterLevel, MIN_MAP_WATER, MAX_MAP_WATER);
+            auto waterLevel = WaterSensor::getValueRaw();
+            isRead = isRead && waterLevel.has_value();
         #endif
 
-        #if CONFIG_ENABLE_LCD
-            lcdDevice->print(std::format("{}{:.1f}%", "Moisture:", moistureConverted), 0, 0);
-            #if CONFIG_ENABLE_WATER_SENSOR
-                lcdDevice->print(std::format("{}{:.1f}%", "Water:", waterLevelConverted), 1, 0);
-            #endif
+        if (!isRead) {
+            AFLR_LOGE(TAG.data(), "Sensor read failed, the watering is not decided");
+            sensorPower->set_low();
+            return false;
+        }
+
+        auto moistureConverted = mapToPercentage(*moisture, MIN_MAP_MOISTURE, MAX_MAP_MOISTURE, true);
+        #if CONFIG_ENABLE_WATER_SENSOR
+            auto waterLevelConverted = mapToPercentage(*waterLevel, MIN_MAP_WATER, MAX_MAP_WATER);
+        #else
+            constexpr float waterLevelConverted = 0.0f;
         #endif
 
-        ESP_LOGI(
+        report({ControlReportKind::READINGS, moistureConverted, waterLevelConverted, false});
+
+        AFLR_LOGI(
             TAG.data(),
             "Moisture:%.1f%%(%d)",
             moistureConverted,
-            moisture
+            *moisture
         );
         #if CONFIG_ENABLE_WATER_SENSOR
-            ESP_LOGI(
+            AFLR_LOGI(
                 TAG.data(),
                 "Water level: %.1f%%(%d)",
                 waterLevelConverted,
-                waterLevel
+                *waterLevel
             );
         #endif
 
-        if (moisture >= MIN_LEVEL_MOISTURE) {
+        if (*moisture >= MIN_LEVEL_MOISTURE) {
             #if CONFIG_ENABLE_WATER_SENSOR
-                if (waterLevel <= MIN_LEVEL_WATER) {
-                    ESP_LOGW(TAG.data(), "%s", WARNING_MESSAGE.data());
-                    #if CONFIG_ENABLE_LCD
-                        lcdDevice->clear();
-                        lcdDevice->print(WARNING_MESSAGE.data(), 0, 0);
-                    #endif
+                if (*waterLevel <= MIN_LEVEL_WATER) {
+                    AFLR_LOGW(TAG.data(), "%s", WARNING_MESSAGE.data());
+                    report({ControlReportKind::LOW_WATER, moistureConverted, waterLevelConverted, false});
                     warningLed->set_high();
             } else {
             #endif
-                pumpPower->set_high();
-                std::this_thread::sleep_for(std::chrono::seconds(PUMPING_TIME)); // Pump operating time.
-                pumpPower->set_low();
+                runPump();
 
                 // TODO REFACTORING!
-                moisture = moistureSensor->getValueRaw();
-                moistureConverted = mapToPercentage(moisture, MIN_MAP_MOISTURE, MAX_MAP_MOISTURE, true);
+                moisture = MoistureSensor::getValueRaw();
+                isRead = moisture.has_value();
                 #if CONFIG_ENABLE_WATER_SENSOR
-                    waterLevel = waterSensor->getValueRaw();
-                    waterLevelConverted = mapToPercentage(waterLevel, MIN_MAP_WATER, MAX_MAP_WATER);
+                    waterLevel = WaterSensor::getValueRaw();
+                    isRead = isRead && waterLevel.has_value();
                 #endif
-                #if CONFIG_ENABLE_LCD
-                    lcdDevice->print(std::format("{}{:.1f}%", "Moisture:", moistureConverted), 0, 0);
-                    lcdDevice->print(std::format("{}{:.1f}%", "Water:", waterLevelConverted), 1, 0);
+                if (!isRead) {
+                    AFLR_LOGE(TAG.data(), "Sensor read after the watering failed");
+                    sensorPower->set_low();
+                    return false;
+                }
+
+                moistureConverted = mapToPercentage(*moisture, MIN_MAP_MOISTURE, MAX_MAP_MOISTURE, true);
+                #if CONFIG_ENABLE_WATER_SENSOR
+                    waterLevelConverted = mapToPercentage(*waterLevel, MIN_MAP_WATER, MAX_MAP_WATER);
                 #endif
-                ESP_LOGI(TAG.data(), "Irrigation process completed.");
+                report({ControlReportKind::READINGS, moistureConverted, waterLevelConverted, false});
+                AFLR_LOGI(TAG.data(), "Irrigation process completed.");
             #if CONFIG_ENABLE_WATER_SENSOR
             }
             #endif
         } else {
-            ESP_LOGI(TAG.data(), "No irrigation needed.");
+            AFLR_LOGI(TAG.data(), "No irrigation needed.");
         }
 
         sensorPower->set_low();
-        scheduleNextLaunch();
 
+        return true;
     }
 
-    void IrrigationSystem::scheduleNextLaunch() const {
-        auto timeToNextRun = calculateNextTime(TARGET_HOUR, TARGET_MINUTES);
+    void IrrigationSystem::runPump() const {
+        const uint8_t brownouts = CycleCheckpoint::getBrownouts();
 
-        ESP_LOGI(TAG.data(), "Scheduling next run in %llu seconds.", timeToNextRun / 1000000ULL);
-        esp_deep_sleep(timeToNextRun);
-    }
+        if (brownouts > MAX_PUMP_BROWNOUTS) {
+            AFLR_LOGE(TAG.data(), "Pump skipped after %u brownouts, check the supply", brownouts);
+            CycleCheckpoint::enter(CyclePhase::VERIFYING);
+            return;
+        }
+
+        // Each brownout on a previous attempt takes a step of power and stretches the soft start.
+        const auto powerPercent = static_cast<uint8_t>(std::max(100 - brownouts * BROWNOUT_POWER_STEP, MIN_PUMP_POWER));
+        const uint32_t softStartMs = CONFIG_PUMP_SOFT_START_MS * (1U + brownouts);
+        // A resumed run only makes up what the interrupted one did not deliver.
+        const uint32_t previousMs = CycleCheckpoint::getPumpElapsedMs();
+        const uint32_t previousMl = CycleCheckpoint::getDeliveredMl();
+        const uint32_t limitMs = mEnergyManager.limitPumpTime(PUMPING_TIME) * 1000U;
+        auto& stats = persistentStats().cycle;
+        uint32_t elapsedMs = previousMs;
+        uint32_t volumeMl = previousMl;
+        bool isDelivered = previousMs >= limitMs;
+
+        #if CONFIG_ENABLE_FLOW_METER
+            isDelivered = isDelivered || previousMl >= CONFIG_DOSE_TARGET_ML;
+        #endif
+        if (isDelivered) {
+            AFLR_LOGI(TAG.data(), "The dose was delivered before the reset");
+            CycleCheckpoint::enter(CyclePhase::VERIFYING);
+            return;
+        }
 
-    uint64_t IrrigationSystem::calculateNextTime(uint16_t targetHour, uint16_t targetMinute) const {
-        std::time_t now;
-        std::tm timeInfo;
+        CycleCheckpoint::enter(CyclePhase::PUMPING);
 
-        std::time(&now);
-        setenv("TZ", "GMT-3", 1);
-        tzset();
-        localtime_r(&now, &timeInfo);
+        Pump pump{BOARD.pumpRail, CONFIG_PUMP_PWM_FREQUENCY_HZ};
+        #if CONFIG_ENABLE_FLOW_METER
+            FlowMeter flowMeter{BOARD.flowMeter, CONFIG_FLOW_METER_PULSES_PER_LITRE};
 
-        timeInfo.tm_sec = 0;
-        timeInfo.tm_min = targetMinute;
-        timeInfo.tm_hour = targetHour;
+            flowMeter.start();
+        #endif
+        const auto startedAt = std::chrono::steady_clock::now();
+
+        pump.start(softStartMs, powerPercent);
+        while (true) {
+            elapsedMs = previousMs + std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - startedAt
+            ).count();
+            #if CONFIG_ENABLE_FLOW_METER
+                volumeMl = previousMl + flowMeter.getVolumeMl();
+            #endif
+            CycleCheckpoint::recordPump(elapsedMs, volumeMl);
 
-        std::time_t targetTime = std::mktime(&timeInfo);
+            // PUMPING_TIME is the pump time without a flow meter, and the safety limit for an empty tank
+            // or a failed flow sensor with one.
+            if (elapsedMs >= limitMs) {
+                break;
+            }
+            #if CONFIG_ENABLE_FLOW_METER
+                if (volumeMl >= CONFIG_DOSE_TARGET_ML) {
+                    break;
+                }
+            #endif
+            std::this_thread::sleep_for(std::chrono::milliseconds(FLOW_POLL_INTERVAL_MS));
+        }
+        pump.stop();
+        #if CONFIG_ENABLE_FLOW_METER
+            flowMeter.stop();
+        #endif
+        CycleCheckpoint::enter(CyclePhase::VERIFYING);
 
-        if (targetTime <= now) {
-            targetTime += NEXT_DAY;
+        stats.pumpTimeMs = elapsedMs;
+        stats.volumeMl = volumeMl;
+        stats.flowRateMlPerMin = stats.pumpTimeMs > 0 ? static_cast<uint64_t>(stats.volumeMl) * 60000 / stats.pumpTimeMs : 0;
+
+        AFLR_LOGI(
+            TAG.data(),
+            "Pumped %lu ml in %lu ms (%lu ml/min)",
+            stats.volumeMl,
+            stats.pumpTimeMs,
+            stats.flowRateMlPerMin
+        );
+    }
+
+    void IrrigationSystem::scheduleNextLaunch(bool isCycleCompleted) const {
+        const bool isOnline = waitForNetwork();
+
+        if (isCycleCompleted) {
+            mOtaManager.confirmImage(); // A pending image is kept only once it has completed a full cycle.
         }
+        if (isOnline) {
+            waitForNetworkStopped(); // An OTA check still running ends with the budget at the latest.
+        }
+        #if CONFIG_EVENT_MONITOR_DUMP_ON_SLEEP
+            dumpStats();
+        #endif
 
-        ESP_LOGI(TAG.data(), "Current time: %s", std::asctime(std::localtime(&now)));
-        ESP_LOGI(TAG.data(), "Target time: %s", std::asctime(std::localtime(&targetTime)));
+        if (!isOnline) {
+            AFLR_LOGW(
+                TAG.data(),
+                "Offline, %s",
+                isClockSet() ? "scheduling from RTC time" : "clock was never set, using the offline interval"
+            );
+        }
+
+        auto timeToNextRun = isClockSet()
+            ? mScheduler.microsecondsUntilNext(std::time(nullptr))
+            : CONFIG_OFFLINE_WAKE_INTERVAL_MIN * 60ULL * 1000000ULL;
+        const auto minSleepUs = mEnergyManager.getMinSleepUs();
+
+        if (timeToNextRun < minSleepUs) {
+            // Slots closer than the minimal sleep are skipped, the wake still lands on a slot.
+            timeToNextRun = isClockSet()
+                ? minSleepUs + mScheduler.microsecondsUntilNext(std::time(nullptr) + static_cast<std::time_t>(minSleepUs / 1000000ULL))
+                : minSleepUs;
+            AFLR_LOGI(TAG.data(), "Sleep stretched by the energy policy");
+        }
+
+        AFLR_LOGI(TAG.data(), "Scheduling next run in %llu seconds.", timeToNextRun / 1000000ULL);
+        CycleCheckpoint::complete();
+
+        const uint64_t sleepUs = WakeStub::arm(timeToNextRun);
+
+        prepareForSleep();
+        esp_deep_sleep(sleepUs);
+    }
+
+    void IrrigationSystem::prepareForSleep() const {
+        #if CONFIG_ENABLE_LCD
+            // Also when this wake left the display alone, the expander powers up with the backlight on.
+            if (I2cDevice* pDevice = mI2cBusManager.getDevice(0, BOARD.lcdAddress)) {
+                Lcd::switchOffBacklight(pDevice);
+            }
+        #endif
+        mI2cBusManager.flush(pdMS_TO_TICKS(I2C_FLUSH_TIMEOUT)); // Queued display writes must reach the bus before sleep.
+        ESP_ERROR_CHECK(esp_sleep_enable_ext0_wakeup(BOARD.settingsButton, 0));
+        SleepPins::hold();
+        #if CONFIG_ENABLE_BINARY_LOG
+            // Last, so the records of this wake are in. Below the threshold they wait for the next wakes.
+            if (BinaryLog::getUsedPercent() >= CONFIG_BINARY_LOG_FLUSH_PERCENT) {
+                BinaryLog::flush();
+            }
+        #endif
+    }
 
-        return static_cast<uint64_t>((targetTime - now) * 1000000ULL); // us.
+    bool IrrigationSystem::isClockSet() {
+        return std::time(nullptr) >= MIN_VALID_TIME; // The RTC keeps the time across deep sleep once set.
     }
 
     void IrrigationSystem::openSettings() const {
+        AFLR_LOGI(TAG.data(), "Woken by the settings button");
+        dumpStats(); // Field readout of the monitor histograms and the binary log.
+    }
 
+    void IrrigationSystem::dumpStats() const {
+        EventLoopMonitor::dump();
+        mI2cBusManager.logStats();
+        #if CONFIG_ENABLE_BINARY_LOG
+            BinaryLog::flush();
+        #endif
     }
 
 }
\ No newline at end of file
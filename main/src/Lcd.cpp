@@ -1,57 +1,55 @@
 #include "Lcd.hpp"
+#include "BinaryLog.hpp"
 
+#include <algorithm>
+#include <stdexcept>
 #include <vector>
 
 namespace autflr {
-    Lcd::Lcd(idf::I2CMaster* pMaster, uint8_t address) : mMasterPtr{pMaster}, mAddress{idf::I2CAddress(address)} {
-        if (!mMasterPtr) {
-            ESP_LOGE(TAG, "I2CMaster instance is null");
-            throw std::invalid_argument("I2CMaster instance cannot be null");
+    static_assert(
+        Lcd::encode(0x28, 0x0C, 0x08) == std::array<uint8_t, 4>{0x2C, 0x28, 0x8C, 0x88},
+        "Command encoding keeps the backlight on and strobes enable"
+    );
+    static_assert(
+        Lcd::encode('A', 0x0D, 0x09) == std::array<uint8_t, 4>{0x4D, 0x49, 0x1D, 0x19},
+        "Data encoding sets the register select bit"
+    );
+
+    Lcd::Lcd(I2cDevice* pDevice) : mDevicePtr{pDevice} {
+        if (!mDevicePtr) {
+            AFLR_LOGE(TAG.data(), "I2C device is null");
+            throw std::invalid_argument("I2C device cannot be null");
         }
         initialize();
     }
 
     void Lcd::initialize() const {
-        constexpr std::chrono::milliseconds INIT_DELAY_MS(150);
-        constexpr std::chrono::milliseconds CMD_DELAY_MS(6);
-        constexpr std::chrono::microseconds CMD_DELAY_US(60);
-        constexpr std::chrono::milliseconds CMD_DELAY_FINISHED_MS(4);
-
-        std::this_thread::sleep_for(INIT_DELAY_MS);
-        sendCmd(0x30);
-        std::this_thread::sleep_for(CMD_DELAY_MS);
-        sendCmd(0x30);
-        std::this_thread::sleep_for(INIT_DELAY_MS);
-        sendCmd(0x30);
-        std::this_thread::sleep_for(INIT_DELAY_MS);
-        sendCmd(0x20);
-        std::this_thread::sleep_for(INIT_DELAY_MS);
-
-        sendCmd(0x28);
-        std::this_thread::sleep_for(CMD_DELAY_US);
-        sendCmd(0x08);
-        std::this_thread::sleep_for(CMD_DELAY_US);
-        sendCmd(0x06);
-        std::this_thread::sleep_for(CMD_DELAY_US);
-        sendCmd(0x0C);
-        std::this_thread::sleep_for(CMD_DELAY_US);
-        sendCmd(0x01);
-        std::this_thread::sleep_for(CMD_DELAY_FINISHED_MS);
-        sendCmd(0x02);
-        std::this_thread::sleep_for(CMD_DELAY_FINISHED_MS);
+        constexpr uint32_t INIT_DELAY_US = 150000;
+        constexpr uint32_t CMD_DELAY_US = 6000;
+        constexpr uint32_t CMD_DELAY_SHORT_US = 60;
+        constexpr uint32_t CMD_DELAY_FINISHED_US = 4000;
+
+        // The whole sequence is queued at once, the delays are kept by the bus worker.
+        mDevicePtr->delay(INIT_DELAY_US);
+        sendCmd(0x30, CMD_DELAY_US);
+        sendCmd(0x30, INIT_DELAY_US);
+        sendCmd(0x30, INIT_DELAY_US);
+        sendCmd(0x20, INIT_DELAY_US);
+
+        sendCmd(0x28, CMD_DELAY_SHORT_US);
+        sendCmd(0x08, CMD_DELAY_SHORT_US);
+        sendCmd(0x06, CMD_DELAY_SHORT_US);
+        sendCmd(0x0C, CMD_DELAY_SHORT_US);
+        sendCmd(0x01, CMD_DELAY_FINISHED_US);
+        sendCmd(0x02, CMD_DELAY_FINISHED_US);
 
         clear();
 
-        ESP_LOGI(TAG, "Initialization is completed!");
+        AFLR_LOGI(TAG.data(), "Initialization is queued!");
     }
 
     void Lcd::putCursor(uint16_t row, uint16_t col) const {
-        constexpr uint16_t MAX_ROW = 1;
-        constexpr uint16_t MAX_COLUMN = 15;
-        row = std::min(row, MAX_ROW);
-        col = std::min(col, MAX_COLUMN);
-
-        sendCmd((row == 0 ? ROW_0_OFFSET : ROW_1_OFFSET) | col);
+        sendCmd(cursorCmd(row, col));
     }
 
     void Lcd::print(
@@ -59,36 +57,37 @@ namespace autflr {
         uint8_t row,
         uint32_t col
     ) const {
-        putCursor(row, col);
-        for (auto itt = message.begin(); itt != message.end(); ++itt) {
-            sendData(*itt);
+        std::vector<uint8_t> bits;
+        bits.reserve((message.size() + 1) * 4);
+
+        // Cursor and text go out together instead of one transaction per character.
+        const auto cursorBits = encode(cursorCmd(row, col), ENABLE_BIT, DISABLE_BIT);
+        bits.insert(bits.end(), cursorBits.begin(), cursorBits.end());
+        for (char c : message) {
+            const auto dataBits = encode(static_cast<uint8_t>(c), ENABLE_DATA, DISABLE_DATA);
+            bits.insert(bits.end(), dataBits.begin(), dataBits.end());
         }
+
+        mDevicePtr->write(bits.data(), bits.size());
     }
 
-    void Lcd::sendCmd(uint8_t cmd) const {
-        uint8_t highOrderBit = cmd & 0xF0;
-        uint8_t lowOrderBit = cmd << 4;
-        std::vector<uint8_t> bits = {
-            static_cast<uint8_t>(highOrderBit | ENABLE_BIT),
-            static_cast<uint8_t>(highOrderBit | DISABLE_BIT),
-            static_cast<uint8_t>(lowOrderBit | ENABLE_BIT),
-            static_cast<uint8_t>(lowOrderBit | DISABLE_BIT)
-        };
-
-        mMasterPtr->sync_write(mAddress, bits);
+    uint8_t Lcd::cursorCmd(uint16_t row, uint32_t col) {
+        constexpr uint16_t MAX_ROW = 1;
+        constexpr uint32_t MAX_COLUMN = 15;
+
+        return (std::min(row, MAX_ROW) == 0 ? ROW_0_OFFSET : ROW_1_OFFSET) | std::min(col, MAX_COLUMN);
+    }
+
+    void Lcd::switchOffBacklight(I2cDevice* pDevice) {
+        if (pDevice->write(&BACKLIGHT_OFF, 1) != ESP_OK) {
+            AFLR_LOGW(TAG.data(), "Failed to queue the backlight switch-off");
+        }
     }
 
-    void Lcd::sendData(uint8_t data) const {
-        uint8_t highOrderBit = data & 0xF0;
-        uint8_t lowOrderBit = data << 4;
-        std::vector<uint8_t> bits = {
-            static_cast<uint8_t>(highOrderBit | ENABLE_DATA),
-            static_cast<uint8_t>(highOrderBit | DISABLE_DATA),
-            static_cast<uint8_t>(lowOrderBit | ENABLE_DATA),
-            static_cast<uint8_t>(lowOrderBit | DISABLE_DATA)
-        };
-
-        mMasterPtr->sync_write(mAddress, bits);
+    void Lcd::sendCmd(uint8_t cmd, uint32_t postDelayUs) const {
+        const auto bits = encode(cmd, ENABLE_BIT, DISABLE_BIT);
+
+        mDevicePtr->write(bits.data(), bits.size(), postDelayUs);
     }
 
 }
\ No newline at end of file
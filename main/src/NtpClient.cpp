@@ -0,0 +1,257 @@
+#include "NtpClient.hpp"
+#include "BinaryLog.hpp"
+#include "MeasureConstants.hpp"
+#include "StringExtension.hpp"
+
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "lwip/inet.h"
+#include "lwip/netdb.h"
+#include "lwip/sockets.h"
+#include "sdkconfig.h"
+#include "soc/soc.h"
+
+#include <algorithm>
+#include <string>
+#include <sys/time.h>
+
+namespace autflr {
+    namespace {
+        struct NtpPacket {
+            uint8_t flags; // Leap indicator, version and mode.
+            uint8_t stratum;
+            uint8_t poll;
+            int8_t precision;
+            uint32_t rootDelay;
+            uint32_t rootDispersion;
+            uint32_t referenceId;
+            uint32_t referenceTs[2];
+            uint32_t originTs[2];
+            uint32_t receiveTs[2];
+            uint32_t transmitTs[2];
+        };
+        static_assert(sizeof(NtpPacket) == 48, "NTP packets are 48 bytes");
+
+        struct DnsCache {
+            uint32_t configHash; // The cache is dropped when the server list changes.
+            std::array<uint32_t, NTP_MAX_SERVERS> addresses;
+        };
+
+        constexpr uint8_t NTP_CLIENT_FLAGS = 4 << 3 | 3; // No leap warning, version 4, client mode.
+        constexpr uint8_t NTP_MODE_SERVER = 4;
+        constexpr uint8_t NTP_LEAP_UNSYNCHRONIZED = 3;
+        constexpr uint8_t NTP_MAX_STRATUM = 15;
+        constexpr uint16_t NTP_PORT = 123;
+        constexpr int64_t NTP_UNIX_OFFSET_S = 2208988800LL; // 1900-01-01 to 1970-01-01.
+        constexpr uint32_t TASK_STACK_SIZE = 4096;
+        constexpr UBaseType_t TASK_PRIORITY = 5;
+
+        constexpr uint32_t hashConfig(std::string_view text) {
+            uint32_t hash = 2166136261U; // FNV-1a
+
+            for (const char c : text) {
+                hash = (hash ^ static_cast<uint8_t>(c)) * 16777619U;
+            }
+
+            return hash;
+        }
+
+        int64_t toUnixUs(const uint32_t (&timestamp)[2]) {
+            const int64_t seconds = ntohl(timestamp[0]);
+            const uint64_t fraction = ntohl(timestamp[1]);
+
+            return (seconds - NTP_UNIX_OFFSET_S) * 1000000 + static_cast<int64_t>((fraction * 1000000) >> 32);
+        }
+
+        bool isValidReply(const NtpPacket& reply, const NtpPacket& request) {
+            const uint8_t stratum = reply.stratum;
+
+            return (reply.flags & 0x7) == NTP_MODE_SERVER
+                && reply.flags >> 6 != NTP_LEAP_UNSYNCHRONIZED
+                && stratum >= 1 && stratum <= NTP_MAX_STRATUM
+                && reply.originTs[0] == request.transmitTs[0] && reply.originTs[1] == request.transmitTs[1]
+                && reply.transmitTs[0] != 0;
+        }
+    }
+
+    RTC_DATA_ATTR static DnsCache sDnsCache;
+
+    void NtpClient::startAsync(NtpCompletion completion, void* arg) {
+        if (mIsStarted.exchange(true)) {
+            return; // Got an IP again after a reconnect, the first sync is still running or done.
+        }
+
+        mCompletion = completion;
+        mCompletionArg = arg;
+        // Next to the Wi-Fi and lwIP tasks, the APP core belongs to the control task.
+        if (xTaskCreatePinnedToCore(&NtpClient::run, "ntp", TASK_STACK_SIZE, this, TASK_PRIORITY, nullptr, PRO_CPU_NUM) != pdPASS) {
+            AFLR_LOGE(TAG.data(), "Failed to create the NTP task");
+            completion(ESP_ERR_NO_MEM, arg);
+        }
+    }
+
+    void NtpClient::run(void* arg) {
+        auto* client = static_cast<NtpClient*>(arg);
+        const esp_err_t result = client->sync();
+
+        client->mCompletion(result, client->mCompletionArg);
+        vTaskDelete(nullptr);
+    }
+
+    esp_err_t NtpClient::sync() {
+        const int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+
+        if (sock < 0) {
+            AFLR_LOGE(TAG.data(), "Failed to create socket: errno %d", errno);
+            return ESP_FAIL;
+        }
+
+        const int64_t startedAtUs = esp_timer_get_time();
+        esp_err_t result = ESP_ERR_TIMEOUT;
+
+        for (uint8_t round = 0; round < NTP_MAX_ROUNDS && result != ESP_OK; ++round) {
+            std::array<Server, NTP_MAX_SERVERS> servers{};
+
+            if (resolveServers(servers) == 0) {
+                AFLR_LOGW(TAG.data(), "No server resolved in round %u", round + 1);
+                sDnsCache.configHash = 0;
+                continue;
+            }
+
+            NtpPacket request{};
+            request.flags = NTP_CLIENT_FLAGS;
+            request.transmitTs[0] = esp_random(); // Echoed back as the origin, ties a reply to this round.
+            request.transmitTs[1] = esp_random();
+
+            for (auto& server : servers) {
+                if (server.address == 0) {
+                    continue;
+                }
+
+                sockaddr_in to{};
+                to.sin_family = AF_INET;
+                to.sin_port = htons(NTP_PORT);
+                to.sin_addr.s_addr = server.address;
+                server.sentAtUs = esp_timer_get_time();
+                sendto(sock, &request, sizeof(request), 0, reinterpret_cast<const sockaddr*>(&to), sizeof(to));
+            }
+
+            const int64_t deadlineUs = esp_timer_get_time() + NTP_ROUND_TIMEOUT * 1000LL;
+            int64_t nowUs = 0;
+
+            while (result != ESP_OK && (nowUs = esp_timer_get_time()) < deadlineUs) {
+                const timeval timeout{
+                    .tv_sec = static_cast<time_t>((deadlineUs - nowUs) / 1000000),
+                    .tv_usec = static_cast<suseconds_t>((deadlineUs - nowUs) % 1000000),
+                };
+                NtpPacket reply{};
+                sockaddr_in from{};
+                socklen_t fromLength = sizeof(from);
+
+                setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                const int length = recvfrom(
+                    sock, &reply, sizeof(reply), 0, reinterpret_cast<sockaddr*>(&from), &fromLength
+                );
+                const int64_t receivedAtUs = esp_timer_get_time();
+                const auto server = std::find_if(servers.begin(), servers.end(), [&from](const Server& candidate) {
+                    return candidate.address != 0 && candidate.address == from.sin_addr.s_addr;
+                });
+
+                if (length < static_cast<int>(sizeof(reply)) || server == servers.end() || !isValidReply(reply, request)) {
+                    continue;
+                }
+
+                // The server's own processing time is not part of the network delay.
+                const int64_t transmitUs = toUnixUs(reply.transmitTs);
+                const int64_t roundTripUs = receivedAtUs - server->sentAtUs - (transmitUs - toUnixUs(reply.receiveTs));
+                const int64_t timeUs = transmitUs + roundTripUs / 2;
+                const timeval time{
+                    .tv_sec = static_cast<time_t>(timeUs / 1000000),
+                    .tv_usec = static_cast<suseconds_t>(timeUs % 1000000),
+                };
+
+                settimeofday(&time, nullptr); // Stepped at once, a sleeping device has nothing to smooth.
+                AFLR_LOGI(
+                    TAG.data(),
+                    "Clock set by server #%u, round trip %lld us",
+                    static_cast<unsigned>(server - servers.begin()),
+                    roundTripUs
+                );
+                result = ESP_OK;
+            }
+
+            if (result != ESP_OK) {
+                AFLR_LOGW(TAG.data(), "No valid reply in round %u, resolving again", round + 1);
+                sDnsCache.configHash = 0;
+            }
+        }
+        close(sock);
+
+        AFLR_LOGI(
+            TAG.data(),
+            "Sync %s after %lld ms",
+            result == ESP_OK ? "done" : "failed",
+            (esp_timer_get_time() - startedAtUs) / 1000
+        );
+        return result;
+    }
+
+    size_t NtpClient::resolveServers(std::array<Server, NTP_MAX_SERVERS>& servers) const {
+        constexpr std::string_view SERVERS = CONFIG_NTP_SERVERS;
+        constexpr uint32_t SERVERS_HASH = hashConfig(SERVERS);
+        size_t resolved = 0;
+        size_t index = 0;
+        size_t start = 0;
+
+        if (sDnsCache.configHash != SERVERS_HASH) {
+            sDnsCache = {};
+            sDnsCache.configHash = SERVERS_HASH;
+        }
+        while (start < SERVERS.size() && index < NTP_MAX_SERVERS) {
+            const auto end = std::min(SERVERS.find(';', start), SERVERS.size());
+            const auto name = trim(SERVERS.substr(start, end - start));
+
+            start = end + 1;
+            if (name.empty()) {
+                continue;
+            }
+
+            auto& cached = sDnsCache.addresses[index];
+            if (cached == 0) {
+                cached = resolve(name);
+            }
+            servers[index++].address = cached;
+            resolved += cached != 0 ? 1 : 0;
+        }
+
+        return resolved;
+    }
+
+    uint32_t NtpClient::resolve(std::string_view name) {
+        const std::string host{name};
+        in_addr address{};
+
+        if (inet_aton(host.c_str(), &address) != 0) {
+            return address.s_addr; // IP literals need no lookup.
+        }
+
+        addrinfo hints{};
+        addrinfo* result = nullptr;
+
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || result == nullptr) {
+            AFLR_LOGW(TAG.data(), "Failed to resolve %.*s", static_cast<int>(name.size()), name.data());
+            return 0;
+        }
+
+        const uint32_t resolved = reinterpret_cast<const sockaddr_in*>(result->ai_addr)->sin_addr.s_addr;
+        freeaddrinfo(result);
+        AFLR_LOGI(TAG.data(), "Resolved %.*s", static_cast<int>(name.size()), name.data());
+
+        return resolved;
+    }
+
+}
\ No newline at end of file
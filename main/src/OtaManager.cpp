@@ -0,0 +1,256 @@
+#include "OtaManager.hpp"
+#include "BinaryLog.hpp"
+
+#include "esp_delta_ota.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+#include <algorithm>
+#include <memory>
+#include <strings.h>
+
+namespace autflr {
+    const esp_partition_t* OtaManager::sSourcePartition = nullptr;
+
+    OtaManager::OtaManager() : mRunningPartition{esp_ota_get_running_partition()} {}
+
+    void OtaManager::confirmImage() const {
+        esp_ota_img_states_t state;
+
+        if (esp_ota_get_state_partition(mRunningPartition, &state) == ESP_OK && state == ESP_OTA_IMG_PENDING_VERIFY) {
+            AFLR_LOGI(TAG.data(), "Irrigation cycle completed, confirming the new image");
+            ESP_ERROR_CHECK(esp_ota_mark_app_valid_cancel_rollback());
+        }
+    }
+
+    bool OtaManager::isCheckDue() const {
+        esp_ota_img_states_t state;
+
+        return esp_ota_get_state_partition(mRunningPartition, &state) != ESP_OK || state != ESP_OTA_IMG_PENDING_VERIFY;
+    }
+
+    // The server options exist only with OTA on, the image state above is needed either way.
+    #if CONFIG_ENABLE_OTA
+        esp_err_t OtaManager::checkForUpdate(int64_t deadlineUs) {
+            const int64_t remainingMs = (deadlineUs - esp_timer_get_time()) / 1000;
+
+            if (remainingMs <= 0) {
+                AFLR_LOGW(TAG.data(), "No network time left, skipping the update check");
+                return ESP_ERR_TIMEOUT;
+            }
+
+            Sha256Digest runningDigest{};
+            esp_err_t ret = esp_partition_get_sha256(mRunningPartition, runningDigest.data());
+
+            if (ret != ESP_OK) {
+                AFLR_LOGE(TAG.data(), "Failed to hash the running image, skipping the update check: %s", esp_err_to_name(ret));
+                return ret;
+            }
+
+            const std::string url = std::string(CONFIG_OTA_SERVER_URL) + "?base=" + toHex(runningDigest);
+            esp_http_client_config_t httpConfig = {};
+            httpConfig.url = url.c_str();
+            httpConfig.timeout_ms = static_cast<int>(std::min<int64_t>(CONFIG_OTA_HTTP_TIMEOUT_MS, remainingMs));
+            httpConfig.buffer_size = CONFIG_OTA_BUFFER_SIZE;
+            httpConfig.event_handler = &OtaManager::handleHttpEvent;
+            httpConfig.user_data = this;
+
+            struct HttpClientDeleter {
+                void operator()(esp_http_client* pClient) const {
+                    esp_http_client_close(pClient);
+                    esp_http_client_cleanup(pClient);
+                }
+            };
+            std::unique_ptr<esp_http_client, HttpClientDeleter> client{esp_http_client_init(&httpConfig)};
+
+            if (!client) {
+                AFLR_LOGE(TAG.data(), "Failed to initialize HTTP client");
+                return ESP_FAIL;
+            }
+
+            mHasExpectedDigest = false;
+            ret = esp_http_client_open(client.get(), 0);
+
+            if (ret != ESP_OK) {
+                AFLR_LOGE(TAG.data(), "Failed to reach OTA server: %s", esp_err_to_name(ret));
+                return ret;
+            }
+            esp_http_client_fetch_headers(client.get());
+
+            const int status = esp_http_client_get_status_code(client.get());
+
+            if (status == HttpStatus_NoContent || status == HttpStatus_NotModified || status == HttpStatus_NotFound) {
+                AFLR_LOGI(TAG.data(), "Firmware is up to date");
+                return ESP_ERR_NOT_FOUND;
+            }
+            if (status != HttpStatus_Ok) {
+                AFLR_LOGE(TAG.data(), "Unexpected HTTP status %d", status);
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            if (!mHasExpectedDigest) {
+                AFLR_LOGE(TAG.data(), "Server did not send %s", TARGET_DIGEST_HEADER.data());
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+
+            return applyPatch(client.get(), deadlineUs);
+        }
+
+        esp_err_t OtaManager::applyPatch(esp_http_client_handle_t client, int64_t deadlineUs) {
+            const esp_partition_t* targetPartition = esp_ota_get_next_update_partition(nullptr);
+            esp_ota_handle_t otaHandle = 0;
+            esp_err_t ret = esp_ota_begin(targetPartition, OTA_SIZE_UNKNOWN, &otaHandle);
+
+            if (ret != ESP_OK) {
+                AFLR_LOGE(TAG.data(), "esp_ota_begin failed: %s", esp_err_to_name(ret));
+                return ret;
+            }
+
+            sSourcePartition = mRunningPartition;
+            esp_delta_ota_cfg_t deltaConfig = {};
+            deltaConfig.read_cb = &OtaManager::readSource;
+            deltaConfig.write_cb_with_user_data = &OtaManager::writeTarget;
+            deltaConfig.user_data = &otaHandle;
+
+            esp_delta_ota_handle_t deltaHandle = esp_delta_ota_init(&deltaConfig);
+
+            if (deltaHandle == nullptr) {
+                AFLR_LOGE(TAG.data(), "Failed to initialize delta OTA");
+                esp_ota_abort(otaHandle);
+                return ESP_FAIL;
+            }
+
+            // The patch is streamed through one fixed buffer, so RAM usage does not depend on the image size.
+            auto buffer = std::make_unique<char[]>(CONFIG_OTA_BUFFER_SIZE);
+            size_t patchSize = 0;
+
+            while (ret == ESP_OK) {
+                if (esp_timer_get_time() >= deadlineUs) {
+                    AFLR_LOGE(TAG.data(), "Network time budget ran out during the download");
+                    ret = ESP_ERR_TIMEOUT;
+                    break;
+                }
+
+                const int read = esp_http_client_read(client, buffer.get(), CONFIG_OTA_BUFFER_SIZE);
+
+                if (read < 0) {
+                    AFLR_LOGE(TAG.data(), "Patch download failed");
+                    ret = ESP_FAIL;
+                } else if (read == 0) {
+                    if (!esp_http_client_is_complete_data_received(client)) {
+                        AFLR_LOGE(TAG.data(), "Connection closed before the patch was complete");
+                        ret = ESP_FAIL;
+                    }
+                    break;
+                } else {
+                    ret = esp_delta_ota_feed_patch(deltaHandle, reinterpret_cast<const uint8_t*>(buffer.get()), read);
+                    patchSize += read;
+                }
+            }
+
+            if (ret == ESP_OK) {
+                ret = esp_delta_ota_finalize(deltaHandle);
+            }
+            esp_delta_ota_deinit(deltaHandle);
+
+            if (ret != ESP_OK) {
+                AFLR_LOGE(TAG.data(), "Failed to apply patch: %s", esp_err_to_name(ret));
+                esp_ota_abort(otaHandle);
+                return ret;
+            }
+            if ((ret = esp_ota_end(otaHandle)) != ESP_OK) {
+                AFLR_LOGE(TAG.data(), "Patched image is not valid: %s", esp_err_to_name(ret));
+                return ret;
+            }
+
+            Sha256Digest targetDigest{};
+
+            if ((ret = esp_partition_get_sha256(targetPartition, targetDigest.data())) != ESP_OK) {
+                AFLR_LOGE(TAG.data(), "Failed to hash the patched image: %s", esp_err_to_name(ret));
+                return ret;
+            }
+            if (targetDigest != mExpectedDigest) {
+                AFLR_LOGE(TAG.data(), "SHA-256 mismatch, update discarded");
+                return ESP_ERR_INVALID_CRC;
+            }
+            if ((ret = esp_ota_set_boot_partition(targetPartition)) != ESP_OK) {
+                AFLR_LOGE(TAG.data(), "Failed to set boot partition: %s", esp_err_to_name(ret));
+                return ret;
+            }
+
+            AFLR_LOGI(
+                TAG.data(),
+                "Applied %u byte patch to the slot at 0x%lx, booting it on the next wake",
+                patchSize,
+                targetPartition->address
+            );
+            return ESP_OK;
+        }
+
+        esp_err_t OtaManager::handleHttpEvent(esp_http_client_event_t* event) {
+            auto* manager = static_cast<OtaManager*>(event->user_data);
+
+            if (event->event_id == HTTP_EVENT_ON_HEADER
+                && strcasecmp(event->header_key, TARGET_DIGEST_HEADER.data()) == 0
+            ) {
+                manager->mHasExpectedDigest = fromHex(event->header_value, manager->mExpectedDigest);
+            }
+
+            return ESP_OK;
+        }
+
+        esp_err_t OtaManager::readSource(uint8_t* buf, size_t size, int offset) {
+            if (size <= 0) {
+                return ESP_ERR_INVALID_ARG;
+            }
+
+            return esp_partition_read(sSourcePartition, offset, buf, size);
+        }
+
+        esp_err_t OtaManager::writeTarget(const uint8_t* buf, size_t size, void* arg) {
+            if (size <= 0) {
+                return ESP_ERR_INVALID_ARG;
+            }
+
+            return esp_ota_write(*static_cast<esp_ota_handle_t*>(arg), buf, size);
+        }
+
+        std::string OtaManager::toHex(const Sha256Digest& digest) {
+            constexpr std::string_view DIGITS = "0123456789abcdef";
+            std::string hex;
+            hex.reserve(digest.size() * 2);
+
+            for (uint8_t byte : digest) {
+                hex.push_back(DIGITS[byte >> 4]);
+                hex.push_back(DIGITS[byte & 0x0F]);
+            }
+
+            return hex;
+        }
+
+        bool OtaManager::fromHex(std::string_view hex, Sha256Digest& digest) {
+            auto nibble = [](char c) -> int {
+                if (c >= '0' && c <= '9') return c - '0';
+                if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+                if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+                return -1;
+            };
+
+            if (hex.size() != digest.size() * 2) {
+                return false;
+            }
+            for (size_t i = 0; i < digest.size(); ++i) {
+                const int high = nibble(hex[2 * i]);
+                const int low = nibble(hex[2 * i + 1]);
+
+                if (high < 0 || low < 0) {
+                    return false;
+                }
+                digest[i] = static_cast<uint8_t>((high << 4) | low);
+            }
+
+            return true;
+        }
+    #endif
+
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "Pump.hpp"
+#include "BinaryLog.hpp"
+
+#include <algorithm>
+
+namespace autflr {
+    Pump::Pump(gpio_num_t pin, uint32_t frequencyHz) {
+        const ledc_timer_config_t timerConfig = {
+            .speed_mode = SPEED_MODE,
+            .duty_resolution = RESOLUTION,
+            .timer_num = TIMER,
+            .freq_hz = frequencyHz,
+            .clk_cfg = LEDC_AUTO_CLK,
+        };
+        const ledc_channel_config_t channelConfig = {
+            .gpio_num = pin,
+            .speed_mode = SPEED_MODE,
+            .channel = CHANNEL,
+            .intr_type = LEDC_INTR_DISABLE,
+            .timer_sel = TIMER,
+            .duty = 0,
+            .hpoint = 0,
+        };
+
+        ESP_ERROR_CHECK(ledc_timer_config(&timerConfig));
+        ESP_ERROR_CHECK(ledc_channel_config(&channelConfig));
+        ESP_ERROR_CHECK(ledc_fade_func_install(0));
+    }
+
+    Pump::~Pump() {
+        stop();
+        ledc_fade_func_uninstall();
+    }
+
+    void Pump::start(uint32_t softStartMs, uint8_t powerPercent) const {
+        const uint32_t duty = MAX_DUTY * std::min<uint8_t>(powerPercent, 100) / 100;
+
+        AFLR_LOGI(TAG.data(), "Starting with %lu ms soft start to %u%% power", softStartMs, powerPercent);
+        if (softStartMs == 0) {
+            ESP_ERROR_CHECK(ledc_set_duty(SPEED_MODE, CHANNEL, duty));
+            ESP_ERROR_CHECK(ledc_update_duty(SPEED_MODE, CHANNEL));
+        } else {
+            ESP_ERROR_CHECK(ledc_set_fade_with_time(SPEED_MODE, CHANNEL, duty, softStartMs));
+            ESP_ERROR_CHECK(ledc_fade_start(SPEED_MODE, CHANNEL, LEDC_FADE_NO_WAIT));
+        }
+    }
+
+    void Pump::stop() const {
+        ledc_fade_stop(SPEED_MODE, CHANNEL);
+        ESP_ERROR_CHECK(ledc_set_duty(SPEED_MODE, CHANNEL, 0));
+        ESP_ERROR_CHECK(ledc_update_duty(SPEED_MODE, CHANNEL));
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "Scheduler.hpp"
+#include "BinaryLog.hpp"
+#include "StringExtension.hpp"
+
+#include "esp_log.h"
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstdlib>
+#include <string>
+
+namespace autflr {
+    namespace {
+        template<typename Callback>
+        void forEachToken(std::string_view text, char separator, Callback&& callback) {
+            while (!text.empty()) {
+                const auto end = text.find(separator);
+                const auto token = trim(text.substr(0, end));
+
+                if (!token.empty()) {
+                    callback(token);
+                }
+                text = end == std::string_view::npos ? std::string_view{} : text.substr(end + 1);
+            }
+        }
+
+        bool parseNumber(std::string_view field, uint16_t max, uint16_t& value) {
+            const auto* last = field.data() + field.size();
+            const auto [ptr, ec] = std::from_chars(field.data(), last, value);
+
+            return ec == std::errc{} && ptr == last && value <= max;
+        }
+
+        constexpr uint8_t nextWeekdays(uint8_t weekdays) {
+            return static_cast<uint8_t>(((weekdays << 1) | (weekdays >> (DAYS_PER_WEEK - 1))) & ALL_WEEKDAYS);
+        }
+    }
+
+    Scheduler::Scheduler() : mSlots{DEFAULT_SLOT} {}
+
+    bool Scheduler::configure(std::string_view timezone, std::string_view slots, std::string_view blackouts) {
+        setenv("TZ", std::string(timezone).c_str(), 1);
+        tzset();
+
+        std::vector<BlackoutWindow> windows;
+        forEachToken(blackouts, ';', [&windows](std::string_view entry) {
+            BlackoutWindow window{};
+
+            if (parseBlackout(entry, window)) {
+                windows.push_back(window);
+            } else {
+                AFLR_LOGE(TAG.data(), "Invalid blackout window \"%.*s\"", static_cast<int>(entry.size()), entry.data());
+            }
+        });
+
+        mSlots.clear();
+        forEachToken(slots, ';', [this, &windows](std::string_view entry) {
+            ScheduleSlot slot{};
+
+            if (!parseSlot(entry, slot)) {
+                AFLR_LOGE(TAG.data(), "Invalid slot \"%.*s\"", static_cast<int>(entry.size()), entry.data());
+                return;
+            }
+            for (const auto& window : windows) {
+                slot.weekdays &= ~blackedOutDays(slot, window);
+            }
+            if (slot.weekdays == 0) {
+                AFLR_LOGW(TAG.data(), "Slot \"%.*s\" is always blacked out", static_cast<int>(entry.size()), entry.data());
+                return;
+            }
+            mSlots.push_back(slot);
+        });
+
+        if (mSlots.empty()) {
+            AFLR_LOGE(TAG.data(), "No valid slot, falling back to 18:00 daily");
+            mSlots.push_back(DEFAULT_SLOT);
+            return false;
+        }
+
+        AFLR_LOGI(TAG.data(), "%u slot(s) in time zone %.*s", static_cast<unsigned>(mSlots.size()), static_cast<int>(timezone.size()), timezone.data());
+        return true;
+    }
+
+    std::time_t Scheduler::nextFireTime(std::time_t now) const {
+        std::time_t target = nextFireTime(now, 0);
+
+        // When DST ends a wall-clock time repeats, and mktime may resolve it to the occurrence already past.
+        if (target <= now) {
+            target = nextFireTime(now, 1);
+        }
+
+        return target;
+    }
+
+    std::time_t Scheduler::nextFireTime(std::time_t now, uint16_t minDayOffset) const {
+        std::tm timeInfo;
+        localtime_r(&now, &timeInfo);
+
+        const uint32_t nowSecond = (timeInfo.tm_hour * 60 + timeInfo.tm_min) * 60 + timeInfo.tm_sec;
+        uint32_t nearest = UINT32_MAX; // Wall-clock minutes from the start of today.
+
+        for (const auto& slot : mSlots) {
+            for (uint16_t offset = minDayOffset; offset <= DAYS_PER_WEEK; ++offset) {
+                if (offset == 0 && slot.minuteOfDay * 60U <= nowSecond) {
+                    continue;
+                }
+                if (slot.weekdays & (1U << ((timeInfo.tm_wday + offset) % DAYS_PER_WEEK))) {
+                    nearest = std::min<uint32_t>(nearest, offset * MINUTES_PER_DAY + slot.minuteOfDay);
+                    break;
+                }
+            }
+        }
+
+        timeInfo.tm_mday += nearest / MINUTES_PER_DAY;
+        timeInfo.tm_hour = nearest % MINUTES_PER_DAY / 60;
+        timeInfo.tm_min = nearest % 60;
+        timeInfo.tm_sec = 0;
+        timeInfo.tm_isdst = -1; // Let mktime pick the UTC offset in effect on the target day.
+
+        return std::mktime(&timeInfo);
+    }
+
+    uint64_t Scheduler::microsecondsUntilNext(std::time_t now) const {
+        const std::time_t target = nextFireTime(now);
+
+        #if CONFIG_ENABLE_BINARY_LOG
+            AFLR_LOGI(TAG.data(), "Current time: %lld, target time: %lld", now, target); // Decoded on the host.
+        #else
+            char nowText[32];
+            char targetText[32];
+            std::tm timeInfo;
+
+            std::strftime(nowText, sizeof(nowText), "%a %F %T %Z", localtime_r(&now, &timeInfo));
+            std::strftime(targetText, sizeof(targetText), "%a %F %T %Z", localtime_r(&target, &timeInfo));
+            AFLR_LOGI(TAG.data(), "Current time: %s", nowText);
+            AFLR_LOGI(TAG.data(), "Target time: %s", targetText);
+        #endif
+
+        return static_cast<uint64_t>(target - now) * 1000000ULL; // us.
+    }
+
+    bool Scheduler::parseSlot(std::string_view entry, ScheduleSlot& slot) {
+        std::string_view fields[3] = {{}, {}, "*"};
+        size_t count = 0;
+
+        forEachToken(entry, ' ', [&fields, &count](std::string_view field) {
+            if (count < 3) {
+                fields[count] = field;
+            }
+            ++count;
+        });
+
+        uint16_t minute = 0;
+        uint16_t hour = 0;
+
+        if (count < 2 || count > 3 || !parseNumber(fields[0], 59, minute) || !parseNumber(fields[1], 23, hour)) {
+            return false;
+        }
+        slot.minuteOfDay = hour * 60 + minute;
+
+        return parseWeekdays(fields[2], slot.weekdays);
+    }
+
+    bool Scheduler::parseBlackout(std::string_view entry, BlackoutWindow& window) {
+        const auto space = entry.find(' ');
+        const auto range = entry.substr(0, space);
+        const auto days = space == std::string_view::npos ? std::string_view{"*"} : trim(entry.substr(space + 1));
+        const auto dash = range.find('-');
+
+        return dash != std::string_view::npos
+            && parseClock(range.substr(0, dash), window.startMinute)
+            && parseClock(range.substr(dash + 1), window.endMinute)
+            && parseWeekdays(days, window.weekdays);
+    }
+
+    bool Scheduler::parseWeekdays(std::string_view field, uint8_t& weekdays) {
+        bool isValid = true;
+        weekdays = 0;
+
+        if (field == "*") {
+            weekdays = ALL_WEEKDAYS;
+            return true;
+        }
+
+        forEachToken(field, ',', [&weekdays, &isValid](std::string_view item) {
+            const auto dash = item.find('-');
+            uint16_t first = 0;
+            uint16_t last = 0;
+
+            if (!parseNumber(item.substr(0, dash), DAYS_PER_WEEK, first)
+                || !parseNumber(dash == std::string_view::npos ? item : item.substr(dash + 1), DAYS_PER_WEEK, last)
+                || first > last
+            ) {
+                isValid = false;
+                return;
+            }
+            for (uint16_t day = first; day <= last; ++day) {
+                weekdays |= 1U << (day % DAYS_PER_WEEK); // 7 is Sunday too, as in cron.
+            }
+        });
+
+        return isValid && weekdays != 0;
+    }
+
+    bool Scheduler::parseClock(std::string_view field, uint16_t& minuteOfDay) {
+        const auto colon = field.find(':');
+        uint16_t hour = 0;
+        uint16_t minute = 0;
+
+        if (colon == std::string_view::npos
+            || !parseNumber(field.substr(0, colon), 24, hour)
+            || !parseNumber(field.substr(colon + 1), 59, minute)
+            || hour * 60 + minute > MINUTES_PER_DAY
+        ) {
+            return false;
+        }
+        minuteOfDay = hour * 60 + minute;
+
+        return true;
+    }
+
+    uint8_t Scheduler::blackedOutDays(const ScheduleSlot& slot, const BlackoutWindow& window) {
+        const uint16_t minute = slot.minuteOfDay;
+
+        if (window.startMinute <= window.endMinute) {
+            return minute >= window.startMinute && minute < window.endMinute ? window.weekdays : 0;
+        }
+
+        // The window runs past midnight, so its tail falls on the day after each start day.
+        uint8_t days = 0;
+
+        if (minute >= window.startMinute) {
+            days |= window.weekdays;
+        }
+        if (minute < window.endMinute) {
+            days |= nextWeekdays(window.weekdays);
+        }
+
+        return days;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "SleepPins.hpp"
+#include "BinaryLog.hpp"
+#include "Board.hpp"
+
+#include "driver/gpio.h"
+#include "driver/rtc_io.h"
+#include "sdkconfig.h"
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+namespace autflr {
+    namespace {
+        struct Rail {
+            gpio_num_t pin;
+            uint32_t sleepLevel;
+        };
+
+        // The wake stub's moisture check switches the sensor rail on only around its read.
+        constexpr std::array<Rail, 3> RAILS = {{
+            {BOARD.pumpRail, 0},
+            {BOARD.sensorRail, 0},
+            {BOARD.warningLed, 0},
+        }};
+
+        // Boot mode straps, left to their external pull resistors.
+        constexpr std::array<gpio_num_t, 3> STRAPPING_PINS = {GPIO_NUM_0, GPIO_NUM_2, GPIO_NUM_15};
+
+        constexpr std::string_view TAG = "[SLEEP PINS]";
+
+        template<size_t N>
+        bool contains(const std::array<gpio_num_t, N>& pins, gpio_num_t pin) {
+            return std::find(pins.begin(), pins.end(), pin) != pins.end();
+        }
+
+        bool isUnusedRtcPin(gpio_num_t pin) {
+            return rtc_gpio_is_valid_gpio(pin) && !contains(BOARD_PINS, pin) && !contains(STRAPPING_PINS, pin);
+        }
+    }
+
+    void SleepPins::hold() {
+        size_t isolated = 0;
+
+        for (const auto& rail : RAILS) {
+            if (rtc_gpio_is_valid_gpio(rail.pin)) {
+                rtc_gpio_init(rail.pin);
+                rtc_gpio_set_direction(rail.pin, RTC_GPIO_MODE_OUTPUT_ONLY);
+                rtc_gpio_pullup_dis(rail.pin);
+                rtc_gpio_pulldown_dis(rail.pin);
+                rtc_gpio_set_level(rail.pin, rail.sleepLevel);
+                rtc_gpio_hold_en(rail.pin);
+            } else {
+                gpio_reset_pin(rail.pin); // Takes the pad back from LEDC.
+                gpio_set_pull_mode(rail.pin, GPIO_FLOATING);
+                gpio_set_direction(rail.pin, GPIO_MODE_OUTPUT);
+                gpio_set_level(rail.pin, rail.sleepLevel);
+                gpio_hold_en(rail.pin);
+                gpio_deep_sleep_hold_en();
+            }
+        }
+
+        // A floating input buffer draws current, an isolated pad does not.
+        for (int pin = 0; pin < GPIO_NUM_MAX; ++pin) {
+            const auto gpio = static_cast<gpio_num_t>(pin);
+
+            if (isUnusedRtcPin(gpio)) {
+                rtc_gpio_isolate(gpio);
+                ++isolated;
+            }
+        }
+
+        AFLR_LOGI(TAG.data(), "Rails held, %u unused RTC pin(s) isolated", static_cast<unsigned>(isolated));
+    }
+
+    void SleepPins::release() {
+        for (const auto& rail : RAILS) {
+            // The digital side is set up first, so the rail never floats between the hold and the driver.
+            gpio_set_level(rail.pin, rail.sleepLevel);
+            gpio_set_direction(rail.pin, GPIO_MODE_OUTPUT);
+            if (rtc_gpio_is_valid_gpio(rail.pin)) {
+                rtc_gpio_hold_dis(rail.pin);
+                rtc_gpio_deinit(rail.pin);
+            } else {
+                gpio_hold_dis(rail.pin);
+            }
+        }
+        gpio_deep_sleep_hold_dis();
+
+        // Unused pins stay isolated, only their hold is dropped so a later driver can claim them.
+        for (int pin = 0; pin < GPIO_NUM_MAX; ++pin) {
+            const auto gpio = static_cast<gpio_num_t>(pin);
+
+            if (isUnusedRtcPin(gpio)) {
+                rtc_gpio_hold_dis(gpio);
+            }
+        }
+    }
+
+}
\ No newline at end of file
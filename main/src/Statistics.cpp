@@ -0,0 +1,12 @@
+#include "Statistics.hpp"
+
+#include "esp_attr.h"
+
+namespace autflr {
+    RTC_DATA_ATTR static PersistentStats sPersistentStats;
+
+    PersistentStats& persistentStats() {
+        return sPersistentStats;
+    }
+
+}
\ No newline at end of file
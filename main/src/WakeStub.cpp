@@ -0,0 +1,166 @@
+#include "WakeStub.hpp"
+#include "BinaryLog.hpp"
+#include "Board.hpp"
+#include "MeasureConstants.hpp"
+
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_sleep.h"
+#include "esp_wake_stub.h"
+#include "sdkconfig.h"
+#include "soc/rtc.h"
+
+#if CONFIG_WAKE_STUB_MOISTURE_CHECK
+#include "driver/rtc_io.h"
+#include "esp_rom_sys.h"
+#include "soc/rtc_cntl_reg.h"
+#include "soc/rtc_io_periph.h"
+#include "soc/rtc_io_reg.h"
+#include "soc/sens_reg.h"
+#include "soc/soc.h"
+#endif
+
+#include <string_view>
+
+namespace autflr {
+    namespace {
+        struct WakeStubState {
+            uint32_t wakesLeft; // Stub wakes before the app has to boot.
+            uint32_t intervalS;
+            uint32_t skippedWakes;
+            #if CONFIG_WAKE_STUB_MOISTURE_CHECK
+                // The pad table is in flash, so arm() copies what the stub needs to switch the sensor rail.
+                uint32_t railPadReg;
+                uint32_t railHoldMask;
+                uint32_t railHoldForceMask;
+                uint32_t railOutMask; // Bit in the RTC GPIO output registers, 0 if the rail is no RTC pin.
+            #endif
+        };
+
+        constexpr std::string_view TAG = "[WAKE STUB]";
+    }
+
+    // Only RTC memory and ROM code are usable in the stub, the cache and flash are not up yet.
+    RTC_DATA_ATTR static WakeStubState sState;
+
+    #if CONFIG_WAKE_STUB_MOISTURE_CHECK
+        struct RailHold {
+            uint32_t pad;
+            uint32_t force;
+        };
+
+        /**
+         * Drops whichever hold keeps the sensor rail low and drives it high.
+         * @return The holds that were set, for switchSensorRailOff().
+         */
+        static RailHold RTC_IRAM_ATTR switchSensorRailOn() {
+            const RailHold hold{
+                READ_PERI_REG(sState.railPadReg) & sState.railHoldMask,
+                READ_PERI_REG(RTC_CNTL_HOLD_FORCE_REG) & sState.railHoldForceMask,
+            };
+
+            CLEAR_PERI_REG_MASK(sState.railPadReg, hold.pad);
+            CLEAR_PERI_REG_MASK(RTC_CNTL_HOLD_FORCE_REG, hold.force);
+            WRITE_PERI_REG(RTC_GPIO_OUT_W1TS_REG, sState.railOutMask << RTC_GPIO_OUT_DATA_W1TS_S);
+
+            return hold;
+        }
+
+        /**
+         * Drives the sensor rail low and latches it again, as SleepPins left it.
+         */
+        static void RTC_IRAM_ATTR switchSensorRailOff(const RailHold& hold) {
+            WRITE_PERI_REG(RTC_GPIO_OUT_W1TC_REG, sState.railOutMask << RTC_GPIO_OUT_DATA_W1TC_S);
+            SET_PERI_REG_MASK(RTC_CNTL_HOLD_FORCE_REG, hold.force);
+            SET_PERI_REG_MASK(sState.railPadReg, hold.pad);
+        }
+
+        /**
+         * One-shot read of the moisture channel on ADC1 through the RTC controller registers,
+         * 10 bits and 11 dB attenuation like the app's own sensor.
+         */
+        static uint16_t RTC_IRAM_ATTR readMoisture() {
+            static_assert(BOARD.moisture.unit == ADC_UNIT_1, "The stub only reads ADC1");
+            constexpr uint32_t CHANNEL = BOARD.moisture.channel;
+            constexpr uint32_t ATTEN_11DB = 3;
+            constexpr uint32_t WIDTH_10BIT = 1;
+
+            SET_PERI_REG_BITS(SENS_SAR_MEAS_WAIT2_REG, SENS_FORCE_XPD_SAR, SENS_FORCE_XPD_SAR_PU, SENS_FORCE_XPD_SAR_S);
+            SET_PERI_REG_BITS(SENS_SAR_ATTEN1_REG, 0x3, ATTEN_11DB, CHANNEL * 2);
+            SET_PERI_REG_BITS(SENS_SAR_START_FORCE_REG, SENS_SAR1_BIT_WIDTH, WIDTH_10BIT, SENS_SAR1_BIT_WIDTH_S);
+            SET_PERI_REG_BITS(SENS_SAR_READ_CTRL_REG, SENS_SAR1_SAMPLE_BIT, WIDTH_10BIT, SENS_SAR1_SAMPLE_BIT_S);
+            CLEAR_PERI_REG_MASK(SENS_SAR_READ_CTRL_REG, SENS_SAR1_DIG_FORCE);
+            SET_PERI_REG_MASK(SENS_SAR_MEAS_START1_REG, SENS_MEAS1_START_FORCE | SENS_SAR1_EN_PAD_FORCE);
+            SET_PERI_REG_BITS(SENS_SAR_MEAS_START1_REG, SENS_SAR1_EN_PAD, 1U << CHANNEL, SENS_SAR1_EN_PAD_S);
+            const RailHold railHold = switchSensorRailOn();
+            esp_rom_delay_us(CONFIG_WAKE_STUB_MOISTURE_SETTLE_US);
+
+            CLEAR_PERI_REG_MASK(SENS_SAR_MEAS_START1_REG, SENS_MEAS1_START_SAR);
+            SET_PERI_REG_MASK(SENS_SAR_MEAS_START1_REG, SENS_MEAS1_START_SAR);
+            while (GET_PERI_REG_MASK(SENS_SAR_MEAS_START1_REG, SENS_MEAS1_DONE_SAR) == 0) {}
+
+            const uint16_t value = GET_PERI_REG_BITS2(SENS_SAR_MEAS_START1_REG, SENS_MEAS1_DATA_SAR, SENS_MEAS1_DATA_SAR_S);
+            switchSensorRailOff(railHold);
+            SET_PERI_REG_BITS(SENS_SAR_MEAS_WAIT2_REG, SENS_FORCE_XPD_SAR, 0, SENS_FORCE_XPD_SAR_S);
+
+            return value;
+        }
+    #endif
+
+    static void RTC_IRAM_ATTR wakeStub() {
+        // The settings button always gets the full boot, it is how the statistics are read out.
+        bool isWorkDue = sState.wakesLeft == 0 || (esp_wake_stub_get_wakeup_cause() & RTC_EXT0_TRIG_EN) != 0;
+
+        #if CONFIG_WAKE_STUB_MOISTURE_CHECK
+            // Dry soil cannot wait for the slot.
+            isWorkDue = isWorkDue || (sState.railOutMask != 0 && readMoisture() >= MIN_LEVEL_MOISTURE);
+        #endif
+
+        if (isWorkDue) {
+            sState.wakesLeft = 0;
+            esp_default_wake_deep_sleep();
+            return; // Continue to the full boot.
+        }
+
+        --sState.wakesLeft;
+        ++sState.skippedWakes;
+        esp_wake_stub_set_wakeup_time(static_cast<uint64_t>(sState.intervalS) * 1000000ULL);
+        esp_wake_stub_sleep(&wakeStub);
+    }
+
+    uint64_t WakeStub::arm(uint64_t sleepUs) {
+        constexpr uint64_t INTERVAL_US = CONFIG_WAKE_STUB_INTERVAL_MIN * 60ULL * 1000000ULL;
+
+        if (INTERVAL_US == 0 || sleepUs <= INTERVAL_US) {
+            sState.wakesLeft = 0;
+            return sleepUs;
+        }
+
+        // The remainder is slept first, then whole intervals, so the last stub wake lands on the slot.
+        const auto wakesLeft = static_cast<uint32_t>((sleepUs - 1) / INTERVAL_US);
+        sState.wakesLeft = wakesLeft;
+        sState.intervalS = CONFIG_WAKE_STUB_INTERVAL_MIN * 60;
+        #if CONFIG_WAKE_STUB_MOISTURE_CHECK
+            const int rtcIo = rtc_io_number_get(BOARD.sensorRail);
+
+            if (rtcIo >= 0) {
+                sState.railPadReg = rtc_io_desc[rtcIo].reg;
+                sState.railHoldMask = rtc_io_desc[rtcIo].hold;
+                sState.railHoldForceMask = rtc_io_desc[rtcIo].hold_force;
+                sState.railOutMask = 1U << rtc_io_desc[rtcIo].rtc_num;
+            } else {
+                sState.railOutMask = 0;
+                AFLR_LOGW(TAG.data(), "Sensor rail is no RTC GPIO, the stub skips the moisture check");
+            }
+        #endif
+        esp_set_deep_sleep_wake_stub(&wakeStub);
+
+        AFLR_LOGI(TAG.data(), "%lu wake(s) left to the stub, %lu skipped so far", wakesLeft, sState.skippedWakes);
+        return sleepUs - static_cast<uint64_t>(wakesLeft) * INTERVAL_US;
+    }
+
+    uint32_t WakeStub::getSkippedWakes() {
+        return sState.skippedWakes;
+    }
+
+}
\ No newline at end of file
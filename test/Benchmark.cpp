@@ -0,0 +1,123 @@
+#include "IntExtension.hpp"
+#include "Lcd.hpp"
+#include "RecordingI2c.hpp"
+#include "Scheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace autflr;
+
+namespace {
+    constexpr uint32_t DEFAULT_ITERATIONS = 1000000;
+
+    volatile float sFloatSink;
+    volatile uint32_t sWordSink;
+    volatile std::time_t sTimeSink;
+
+    struct Result {
+        double nsPerOp;
+        double bytesPerTransaction; // 0 for paths that do not touch the bus.
+    };
+
+    template<typename Operation>
+    double measure(uint32_t iterations, Operation&& operation) {
+        const auto start = std::chrono::steady_clock::now();
+
+        for (uint32_t i = 0; i < iterations; ++i) {
+            operation(i);
+        }
+
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / iterations;
+    }
+
+    Result benchMapToPercentage(uint32_t iterations) {
+        const double ns = measure(iterations, [](uint32_t i) {
+            sFloatSink = mapToPercentage(static_cast<uint16_t>(i & 0x3FF), 400, 820, (i & 1) != 0);
+        });
+
+        return {ns, 0.0};
+    }
+
+    Result benchEncode(uint32_t iterations) {
+        const double ns = measure(iterations, [](uint32_t i) {
+            const auto bits = Lcd::encode(static_cast<uint8_t>(i), 0x0D, 0x09);
+            sWordSink = bits[0] | bits[1] << 8 | bits[2] << 16 | static_cast<uint32_t>(bits[3]) << 24;
+        });
+
+        return {ns, 0.0};
+    }
+
+    Result benchNextFireTime(uint32_t iterations) {
+        auto& scheduler = Scheduler::getInstance();
+        const std::time_t start = 1711843200; // 2024-03-31, a DST change.
+
+        scheduler.configure("CET-1CEST,M3.5.0,M10.5.0/3", "0 7 1-5; 30 18 *; 0 12 0,6", "12:00-15:00 1-5");
+        const double ns = measure(iterations, [&scheduler, start](uint32_t i) {
+            sTimeSink = scheduler.nextFireTime(start + static_cast<std::time_t>(i % 10080) * 60);
+        });
+
+        return {ns, 0.0};
+    }
+
+    template<typename Draw>
+    Result benchLcd(uint32_t iterations, Draw&& draw) {
+        auto& bus = RecordingI2c::getInstance();
+        auto device = RecordingI2c::makeDevice(0x27);
+        Lcd lcd{&device};
+
+        bus.setKeepsWrites(false);
+        bus.clear();
+        const double ns = measure(iterations, [&lcd, &draw](uint32_t) {
+            draw(lcd);
+        });
+        const double bytesPerTransaction = static_cast<double>(bus.getTotalBytes()) / bus.getTotalTransactions();
+
+        bus.setKeepsWrites(true);
+        return {ns, bytesPerTransaction};
+    }
+
+    void report(const char* name, const Result& result) {
+        if (result.bytesPerTransaction > 0.0) {
+            std::printf("%-28s %10.1f %12.1f\n", name, result.nsPerOp, result.bytesPerTransaction);
+        } else {
+            std::printf("%-28s %10.1f %12s\n", name, result.nsPerOp, "-");
+        }
+    }
+}
+
+/**
+ * Host microbenchmarks of the math, schedule and display paths. The LCD numbers cover the encoding and
+ * the queueing up to the bus, the wire time depends on the bus speed and is not measured here.
+ * Usage: host_benchmark [iterations]
+ */
+int main(int argc, char** argv) {
+    const uint32_t iterations = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : DEFAULT_ITERATIONS;
+
+    if (iterations == 0) {
+        std::printf("Iterations must be positive\n");
+        return 1;
+    }
+
+    // The slower paths run a tenth as often, at least once so that small counts still divide.
+    const uint32_t slowIterations = std::max<uint32_t>(iterations / 10, 1);
+
+    std::printf("%-28s %10s %12s\n", "benchmark", "ns/op", "bytes/trans");
+    report("mapToPercentage", benchMapToPercentage(iterations));
+    report("Lcd::encode", benchEncode(iterations));
+    report("Scheduler::nextFireTime", benchNextFireTime(slowIterations));
+    report("Lcd::print 16 chars", benchLcd(slowIterations, [](const Lcd& lcd) {
+        lcd.print("Moisture: 42%   ", 0, 0);
+    }));
+    report("Lcd::print 4 chars", benchLcd(slowIterations, [](const Lcd& lcd) {
+        lcd.print("42%", 1, 12);
+    }));
+    report("Lcd::clear", benchLcd(slowIterations, [](const Lcd& lcd) {
+        lcd.clear();
+    }));
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <cstdio>
+
+namespace autflr {
+    inline int& checkFailures() {
+        static int failures = 0;
+        return failures;
+    }
+}
+
+/**
+ * Reports a failed expectation and keeps going, so one run lists every failure.
+ * Each test's main() returns CHECK_RESULT() for ctest.
+ */
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++::autflr::checkFailures(); \
+        } \
+    } while (false)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        const auto checkActual = (actual); \
+        const auto checkExpected = (expected); \
+        if (!(checkActual == checkExpected)) { \
+            std::printf( \
+                "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", \
+                __FILE__, __LINE__, #actual, #expected, \
+                static_cast<long long>(checkActual), static_cast<long long>(checkExpected) \
+            ); \
+            ++::autflr::checkFailures(); \
+        } \
+    } while (false)
+
+#define CHECK_RESULT() (::autflr::checkFailures() == 0 ? 0 : 1)
+
+#endif
\ No newline at end of file
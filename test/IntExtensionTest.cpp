@@ -0,0 +1,55 @@
+#include "Check.hpp"
+#include "IntExtension.hpp"
+#include "MeasureConstants.hpp"
+
+#include <cmath>
+
+using namespace autflr;
+
+namespace {
+    bool isNear(float actual, float expected) {
+        return std::fabs(actual - expected) < 0.01f;
+    }
+
+    // The compile-time edge cases live next to the function, these are the ones a sensor actually hits.
+    void testSensorRange() {
+        CHECK(isNear(mapToPercentage(MIN_MAP_WATER, MIN_MAP_WATER, MAX_MAP_WATER), 0.0f));
+        CHECK(isNear(mapToPercentage(MIN_LEVEL_WATER, MIN_MAP_WATER, MAX_MAP_WATER), 50.63f));
+        CHECK(isNear(mapToPercentage(MAX_MAP_WATER, MIN_MAP_WATER, MAX_MAP_WATER), ONE_HUNDRED_PERC));
+    }
+
+    void testInverted() {
+        // Capacitive probes read lower when wet, so the mapping is inverted.
+        CHECK(isNear(mapToPercentage(505, MIN_MAP_MOISTURE, MAX_MAP_MOISTURE, true), 75.0f));
+        CHECK(isNear(mapToPercentage(MIN_LEVEL_MOISTURE, MIN_MAP_MOISTURE, MAX_MAP_MOISTURE, true), 25.0f));
+        CHECK(isNear(mapToPercentage(0, MIN_MAP_MOISTURE, MAX_MAP_MOISTURE, true), ONE_HUNDRED_PERC));
+        CHECK(isNear(mapToPercentage(UINT16_MAX, MIN_MAP_MOISTURE, MAX_MAP_MOISTURE, true), 0.0f));
+    }
+
+    void testDegenerateRanges() {
+        CHECK(isNear(mapToPercentage(0, 0, 0), 0.0f));
+        CHECK(isNear(mapToPercentage(UINT16_MAX, UINT16_MAX, UINT16_MAX, true), 0.0f));
+        CHECK(isNear(mapToPercentage(1, 0, 1), ONE_HUNDRED_PERC));
+        CHECK(isNear(mapToPercentage(UINT16_MAX, 0, UINT16_MAX, true), 0.0f));
+    }
+
+    void testMonotonic() {
+        float previous = -1.0f;
+
+        for (uint32_t raw = 0; raw <= 1023; ++raw) {
+            const float percent = mapToPercentage(static_cast<uint16_t>(raw), 0, 1023);
+
+            CHECK(percent >= previous && percent <= ONE_HUNDRED_PERC);
+            previous = percent;
+        }
+    }
+}
+
+int main() {
+    testSensorRange();
+    testInverted();
+    testDegenerateRanges();
+    testMonotonic();
+
+    return CHECK_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "Check.hpp"
+#include "Lcd.hpp"
+#include "RecordingI2c.hpp"
+
+#include <stdexcept>
+
+using namespace autflr;
+
+namespace {
+    constexpr uint8_t LCD_ADDRESS = 0x27;
+    constexpr uint8_t CMD_ENABLE = 0x0C;
+    constexpr uint8_t CMD_DISABLE = 0x08;
+    constexpr uint8_t DATA_ENABLE = 0x0D;
+    constexpr uint8_t DATA_DISABLE = 0x09;
+
+    std::vector<uint8_t> command(uint8_t cmd) {
+        const auto bits = Lcd::encode(cmd, CMD_ENABLE, CMD_DISABLE);
+        return {bits.begin(), bits.end()};
+    }
+
+    std::vector<uint8_t> text(uint8_t cursor, std::string_view message) {
+        auto bytes = command(cursor);
+
+        for (char c : message) {
+            const auto bits = Lcd::encode(static_cast<uint8_t>(c), DATA_ENABLE, DATA_DISABLE);
+            bytes.insert(bytes.end(), bits.begin(), bits.end());
+        }
+
+        return bytes;
+    }
+
+    void testInitialization() {
+        auto& bus = RecordingI2c::getInstance();
+        auto device = RecordingI2c::makeDevice(LCD_ADDRESS);
+
+        bus.clear();
+        Lcd lcd{&device};
+
+        const auto& writes = bus.getWrites();
+        const std::vector<uint8_t> expected = {0x30, 0x30, 0x30, 0x20, 0x28, 0x08, 0x06, 0x0C, 0x01, 0x02, 0x01};
+
+        CHECK_EQ(writes.size(), expected.size() + 1);
+        CHECK_EQ(bus.getTotalTransactions(), expected.size() + 1);
+        CHECK_EQ(bus.getTotalBytes(), expected.size() * 4);
+        if (writes.size() != expected.size() + 1) {
+            return;
+        }
+
+        // Power-on wait first, then one 4-byte write per command.
+        CHECK(writes[0].bytes.empty());
+        CHECK_EQ(writes[0].postDelayUs, 150000);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            CHECK(writes[i + 1].bytes == command(expected[i]));
+        }
+        CHECK_EQ(writes.back().postDelayUs, 150000); // clear() leaves the display time to wipe itself.
+    }
+
+    void testPrint() {
+        auto& bus = RecordingI2c::getInstance();
+        auto device = RecordingI2c::makeDevice(LCD_ADDRESS);
+        Lcd lcd{&device};
+
+        bus.clear();
+        lcd.print("Hi", 1, 3);
+
+        // Cursor and text in a single transaction.
+        CHECK_EQ(bus.getWrites().size(), 1);
+        CHECK_EQ(bus.getTotalTransactions(), 1);
+        CHECK(bus.getWrites()[0].bytes == text(0xC3, "Hi"));
+
+        bus.clear();
+        lcd.print("Moisture: 42%", 0, 0);
+        CHECK(bus.getWrites()[0].bytes == text(0x80, "Moisture: 42%"));
+        CHECK_EQ(bus.getTotalTransactions(), 1);
+
+        // A full row is 4 + 16 * 4 bytes, one more than fits in I2C_MAX_PAYLOAD.
+        bus.clear();
+        lcd.print("Low water level!", 1, 0);
+        CHECK_EQ(bus.getTotalBytes(), 68);
+        CHECK_EQ(bus.getTotalTransactions(), 2);
+
+        // Rows and columns past the display are clamped.
+        bus.clear();
+        lcd.print("x", 5, 40);
+        CHECK(bus.getWrites()[0].bytes == text(0xCF, "x"));
+    }
+
+    void testCommands() {
+        auto& bus = RecordingI2c::getInstance();
+        auto device = RecordingI2c::makeDevice(LCD_ADDRESS);
+        Lcd lcd{&device};
+
+        bus.clear();
+        lcd.putCursor(0, 7);
+        lcd.clear();
+        Lcd::switchOffBacklight(&device);
+
+        const auto& writes = bus.getWrites();
+
+        CHECK_EQ(writes.size(), 3);
+        CHECK_EQ(bus.getTotalTransactions(), 3);
+        if (writes.size() != 3) {
+            return;
+        }
+        CHECK(writes[0].bytes == command(0x87));
+        CHECK(writes[1].bytes == command(0x01));
+        CHECK(writes[2].bytes == std::vector<uint8_t>{0x00});
+    }
+
+    void testNullDevice() {
+        bool isThrown = false;
+
+        try {
+            Lcd lcd{nullptr};
+        } catch (const std::invalid_argument&) {
+            isThrown = true;
+        }
+        CHECK(isThrown);
+    }
+}
+
+int main() {
+    testInitialization();
+    testPrint();
+    testCommands();
+    testNullDevice();
+
+    return CHECK_RESULT();
+}
\ No newline at end of file
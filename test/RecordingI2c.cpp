@@ -0,0 +1,50 @@
+#include "RecordingI2c.hpp"
+
+namespace autflr {
+    I2cDevice::I2cDevice(
+        i2c_master_dev_handle_t handle,
+        QueueHandle_t queue,
+        uint8_t bus,
+        uint8_t address
+    ) : mHandle{handle}, mQueue{queue}, mBus{bus}, mAddress{address} {}
+
+    I2cDevice::~I2cDevice() {}
+
+    esp_err_t I2cDevice::write(
+        const uint8_t* data,
+        size_t length,
+        uint32_t postDelayUs,
+        I2cCompletion callback,
+        void* arg
+    ) {
+        RecordingI2c::getInstance().record(data, length, postDelayUs);
+
+        if (callback != nullptr) {
+            callback(ESP_OK, arg);
+        }
+
+        return ESP_OK;
+    }
+
+    I2cDevice RecordingI2c::makeDevice(uint8_t address) {
+        return I2cDevice{nullptr, nullptr, 0, address};
+    }
+
+    void RecordingI2c::record(const uint8_t* data, size_t length, uint32_t postDelayUs) {
+        // A pure delay still takes one queue entry, longer writes are chunked like I2cDevice::write() does.
+        const auto transactions = static_cast<uint32_t>(length == 0 ? 1 : (length + I2C_MAX_PAYLOAD - 1) / I2C_MAX_PAYLOAD);
+
+        mTotalBytes += length;
+        mTotalTransactions += transactions;
+        if (mIsKeepingWrites) {
+            mWrites.push_back({std::vector<uint8_t>(data, data + length), postDelayUs, transactions});
+        }
+    }
+
+    void RecordingI2c::clear() {
+        mWrites.clear();
+        mTotalBytes = 0;
+        mTotalTransactions = 0;
+    }
+
+}
\ No newline at end of file
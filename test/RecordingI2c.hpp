@@ -0,0 +1,68 @@
+#ifndef RECORDING_I2C_HPP
+#define RECORDING_I2C_HPP
+
+#include "I2cBusManager.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace autflr {
+    struct I2cWrite {
+        std::vector<uint8_t> bytes;
+        uint32_t postDelayUs;
+        uint32_t transactions; // As split by the bus worker, I2C_MAX_PAYLOAD bytes at most each.
+    };
+
+    /**
+     * Replaces the bus worker on the host: I2cDevice::write() lands here instead of in the queue.
+     * Linking RecordingI2c.cpp in place of I2cBusManager.cpp swaps the implementation.
+     */
+    class RecordingI2c {
+    public:
+        RecordingI2c(const RecordingI2c&) = delete;
+        RecordingI2c& operator=(const RecordingI2c&) = delete;
+
+        static RecordingI2c& getInstance() {
+            static RecordingI2c instance;
+            return instance;
+        }
+
+        /**
+         * @brief Creates a device that records into this bus. No driver handle or queue is needed.
+         */
+        static I2cDevice makeDevice(uint8_t address);
+
+        void record(const uint8_t* data, size_t length, uint32_t postDelayUs);
+        void clear();
+
+        /**
+         * @brief Benchmarks only keep the totals, so storing the writes does not skew the timing.
+         */
+        inline void setKeepsWrites(bool isKept) {
+            mIsKeepingWrites = isKept;
+        }
+
+        inline const std::vector<I2cWrite>& getWrites() const {
+            return mWrites;
+        }
+
+        inline uint64_t getTotalBytes() const {
+            return mTotalBytes;
+        }
+
+        inline uint64_t getTotalTransactions() const {
+            return mTotalTransactions;
+        }
+
+    private:
+        RecordingI2c() {}
+
+    private:
+        std::vector<I2cWrite> mWrites;
+        uint64_t mTotalBytes{0};
+        uint64_t mTotalTransactions{0};
+        bool mIsKeepingWrites{true};
+    };
+}
+
+#endif
\ No newline at end of file
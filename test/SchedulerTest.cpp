@@ -0,0 +1,104 @@
+#include "Check.hpp"
+#include "Scheduler.hpp"
+
+#include <ctime>
+
+using namespace autflr;
+
+namespace {
+    constexpr std::string_view UTC = "UTC0";
+    constexpr std::string_view CET = "CET-1CEST,M3.5.0,M10.5.0/3";
+    constexpr std::time_t HOUR = 60 * 60;
+
+    std::time_t utc(int year, int month, int day, int hour, int minute, int second = 0) {
+        std::tm timeInfo{};
+        timeInfo.tm_year = year - 1900;
+        timeInfo.tm_mon = month - 1;
+        timeInfo.tm_mday = day;
+        timeInfo.tm_hour = hour;
+        timeInfo.tm_min = minute;
+        timeInfo.tm_sec = second;
+
+        return timegm(&timeInfo);
+    }
+
+    std::time_t next(std::string_view timezone, std::string_view slots, std::time_t now) {
+        auto& scheduler = Scheduler::getInstance();
+
+        CHECK(scheduler.configure(timezone, slots, ""));
+        return scheduler.nextFireTime(now);
+    }
+
+    void testMidnight() {
+        CHECK_EQ(next(UTC, "0 0 *", utc(2024, 3, 10, 23, 59, 30)), utc(2024, 3, 11, 0, 0));
+        // A slot that is due right now has already fired.
+        CHECK_EQ(next(UTC, "0 0 *", utc(2024, 3, 11, 0, 0)), utc(2024, 3, 12, 0, 0));
+        // New Year's Eve rolls over the month and the year.
+        CHECK_EQ(next(UTC, "30 6 *", utc(2024, 12, 31, 7, 0)), utc(2025, 1, 1, 6, 30));
+    }
+
+    void testWeekdays() {
+        // 2024-03-09 is a Saturday, the next weekday slot is Monday.
+        CHECK_EQ(next(UTC, "0 7 1-5", utc(2024, 3, 9, 8, 0)), utc(2024, 3, 11, 7, 0));
+        // The earliest of several slots wins.
+        CHECK_EQ(next(UTC, "0 18 *; 0 7 *", utc(2024, 3, 9, 8, 0)), utc(2024, 3, 9, 18, 0));
+    }
+
+    void testLeapDay() {
+        // 2024-02-29 is a Thursday.
+        CHECK_EQ(next(UTC, "0 6 *", utc(2024, 2, 28, 12, 0)), utc(2024, 2, 29, 6, 0));
+        CHECK_EQ(next(UTC, "0 6 4", utc(2024, 2, 26, 12, 0)), utc(2024, 2, 29, 6, 0));
+        CHECK_EQ(next(UTC, "0 6 4", utc(2024, 2, 29, 7, 0)), utc(2024, 3, 7, 6, 0));
+        // No leap day in 2023.
+        CHECK_EQ(next(UTC, "0 6 *", utc(2023, 2, 28, 12, 0)), utc(2023, 3, 1, 6, 0));
+    }
+
+    void testDaylightSaving() {
+        // Clocks go forward on 2024-03-31 and back on 2024-10-27, the slot stays at 07:00 local.
+        const std::time_t beforeSpring = utc(2024, 3, 30, 7, 0); // 08:00 CET
+        const std::time_t spring = next(CET, "0 7 *", beforeSpring);
+
+        CHECK_EQ(spring, utc(2024, 3, 31, 5, 0));
+        CHECK_EQ(spring - beforeSpring, 22 * HOUR);
+
+        const std::time_t beforeAutumn = utc(2024, 10, 26, 6, 0); // 08:00 CEST
+        const std::time_t autumn = next(CET, "0 7 *", beforeAutumn);
+
+        CHECK_EQ(autumn, utc(2024, 10, 27, 6, 0));
+        CHECK_EQ(autumn - beforeAutumn, 24 * HOUR);
+
+        // 02:30 happens twice on 2024-10-27. From the second 02:10 the first 02:30 is already past.
+        const std::time_t repeatedNow = utc(2024, 10, 27, 1, 10); // 02:10 CET
+        const std::time_t repeated = next(CET, "30 2 *", repeatedNow);
+
+        CHECK(repeated == utc(2024, 10, 27, 1, 30) || repeated == utc(2024, 10, 28, 1, 30));
+        CHECK_EQ(next(CET, "30 2 *", utc(2024, 10, 27, 1, 45)), utc(2024, 10, 28, 1, 30));
+
+        // 02:30 does not exist on 2024-03-31, the slot still fires once that morning.
+        const std::time_t skipped = next(CET, "30 2 *", utc(2024, 3, 31, 0, 0)); // 01:00 CET
+        CHECK(skipped > utc(2024, 3, 31, 0, 0) && skipped <= utc(2024, 3, 31, 2, 0));
+    }
+
+    void testInvalidSchedule() {
+        auto& scheduler = Scheduler::getInstance();
+
+        // Falls back to 18:00 daily.
+        CHECK(!scheduler.configure(UTC, "61 7 *; 0 25 *", ""));
+        CHECK_EQ(scheduler.nextFireTime(utc(2024, 3, 9, 8, 0)), utc(2024, 3, 9, 18, 0));
+        // A slot inside a blackout window is dropped.
+        CHECK(!scheduler.configure(UTC, "0 13 *", "12:00-15:00 *"));
+        CHECK(scheduler.configure(UTC, "0 13 *; 0 7 *", "12:00-15:00 1-5"));
+        CHECK_EQ(scheduler.nextFireTime(utc(2024, 3, 11, 8, 0)), utc(2024, 3, 12, 7, 0));
+        CHECK_EQ(scheduler.nextFireTime(utc(2024, 3, 9, 8, 0)), utc(2024, 3, 9, 13, 0));
+    }
+}
+
+int main() {
+    testMidnight();
+    testWeekdays();
+    testLeapDay();
+    testDaylightSaving();
+    testInvalidSchedule();
+
+    return CHECK_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+/* Host stand-in for the ESP-IDF header. The handles are opaque, the recording I2cDevice never uses them. */
+
+#include "esp_err.h"
+
+typedef struct i2c_master_bus_t* i2c_master_bus_handle_t;
+typedef struct i2c_master_dev_t* i2c_master_dev_handle_t;
\ No newline at end of file
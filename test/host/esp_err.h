@@ -0,0 +1,12 @@
+#pragma once
+/* Host stand-in for the ESP-IDF header, only what the tested modules use. */
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_ARG 0x102
+
+inline const char* esp_err_to_name(esp_err_t code) {
+    return code == ESP_OK ? "ESP_OK" : "ESP_FAIL";
+}
\ No newline at end of file
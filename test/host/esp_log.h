@@ -0,0 +1,19 @@
+#pragma once
+/* Host stand-in for the ESP-IDF header, only what the tested modules use. */
+
+#include <cstdio>
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+#define LOG_LOCAL_LEVEL ESP_LOG_INFO
+
+#define ESP_LOGE(tag, format, ...) std::printf("E %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) std::printf("W %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) std::printf("I %s: " format "\n", tag, ##__VA_ARGS__)
\ No newline at end of file
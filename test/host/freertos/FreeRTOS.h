@@ -0,0 +1,10 @@
+#pragma once
+/* Host stand-in for the FreeRTOS header, only what the tested modules use. */
+
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef unsigned int UBaseType_t;
+typedef struct tskTaskControlBlock* TaskHandle_t;
+
+#define portMAX_DELAY static_cast<TickType_t>(0xFFFFFFFFUL)
\ No newline at end of file
@@ -0,0 +1,6 @@
+#pragma once
+/* Host stand-in for the FreeRTOS header, only what the tested modules use. */
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct QueueDefinition* QueueHandle_t;
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+/* Host configuration: the default devices, with the binary log off so the log macros print. */
+
+#define CONFIG_IDF_TARGET_ESP32 1
+#define CONFIG_ENABLE_WATER_SENSOR 1
+#define CONFIG_ENABLE_LCD 1
+#define CONFIG_I2C_QUEUE_DEPTH 16
\ No newline at end of file
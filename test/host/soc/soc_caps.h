@@ -0,0 +1,4 @@
+#pragma once
+/* Host stand-in for the ESP-IDF header, only what the tested modules use. */
+
+#define SOC_I2C_NUM 2
\ No newline at end of file
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Decodes the "#BL" lines printed by BinaryLog::flush() using the firmware ELF.
+
+Usage:
+    idf.py monitor | tee monitor.log
+    python tools/binlog_decode.py build/auto_floring.elf monitor.log
+
+Requires pyelftools (pip install pyelftools), which ships with ESP-IDF.
+"""
+
+import argparse
+import datetime
+import re
+import struct
+import sys
+
+from elftools.elf.elffile import ELFFile
+from elftools.elf.constants import SH_FLAGS
+
+LEVELS = {1: "E", 2: "W", 3: "I", 4: "D", 5: "V"}
+SPEC = re.compile(r"%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|z|j|t|L)?([diouxXeEfgGcsp%])")
+
+
+class Image:
+    def __init__(self, path):
+        self.sections = []
+        with open(path, "rb") as elf_file:
+            for section in ELFFile(elf_file).iter_sections():
+                if section["sh_flags"] & SH_FLAGS.SHF_ALLOC and section["sh_type"] == "SHT_PROGBITS":
+                    self.sections.append((section["sh_addr"], section.data()))
+
+    def string(self, address):
+        for start, data in self.sections:
+            if start <= address < start + len(data):
+                end = data.index(b"\0", address - start)
+                return data[address - start:end].decode("utf-8", "replace")
+        return None
+
+
+def format_record(image, words):
+    fmt = image.string(words[0])
+    level = LEVELS.get((words[1] >> 8) & 0x7, "?")
+    timestamp = datetime.datetime.fromtimestamp(words[2], datetime.timezone.utc).strftime("%Y-%m-%d %H:%M:%S")
+    args = iter(words[3:])
+
+    if fmt is None:
+        return f"{level} ({timestamp}) <unknown format 0x{words[0]:08x}> {' '.join(f'{w:08x}' for w in words[3:])}"
+
+    def substitute(match):
+        flags, width, precision, length, conversion = match.groups()
+        if conversion == "%":
+            return "%"
+
+        # A '*' width or precision is passed as an int argument ahead of the value.
+        if width == "*":
+            width = str(next(args))
+        if precision == "*":
+            precision = str(next(args))
+        spec = "%" + flags + (width or "") + (f".{precision}" if precision else "")
+        if conversion in "eEfgG":
+            return (spec + conversion) % struct.unpack("<f", struct.pack("<I", next(args)))[0]
+        if conversion == "s":
+            address = next(args)
+            return (spec + "s") % (image.string(address) or f"<0x{address:08x}>")
+        if conversion == "p":
+            return f"0x{next(args):08x}"
+
+        value = next(args)
+        bits = 32
+        if length in ("ll", "j"):
+            value |= next(args) << 32
+            bits = 64
+        if conversion in "di" and value >= 1 << (bits - 1):
+            value -= 1 << bits
+        return (spec + ("d" if conversion in "iu" else conversion)) % value
+
+    try:
+        return f"{level} ({timestamp}) {SPEC.sub(substitute, fmt)}"
+    except StopIteration:
+        return f"{level} ({timestamp}) {fmt} <missing arguments>"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="ELF of the firmware that produced the log")
+    parser.add_argument("log", nargs="?", type=argparse.FileType("r"), default=sys.stdin)
+    args = parser.parse_args()
+
+    image = Image(args.elf)
+    for line in args.log:
+        fields = line.split()
+        if not fields or fields[0] != "#BL":
+            continue
+        if fields[1] == "dropped":
+            if int(fields[2]):
+                print(f"-- {fields[2]} record(s) dropped --")
+            continue
+        print(format_record(image, [int(field, 16) for field in fields[1:]]))
+
+
+if __name__ == "__main__":
+    main()
\ No newline at end of file